@@ -1,79 +1,92 @@
 #include "blockmap.h"
 #include "gm_parser.h"
-#include "gridmap.h"
+
+#include <cassert>
+#include <cstring>
+
+warthog::blockmap::blockmap(uint32_t h, uint32_t w)
+	: header_(h, w, "octile")
+{
+	filename_[0] = 0;
+	this->init_db();
+}
 
 warthog::blockmap::blockmap(const char* filename)
 {
+	strcpy(filename_, filename);
 	warthog::gm_parser parser(filename);
-	this->header_ = new gm_header(parser.get_header());
-
-	blocks_ = new gridmap**[this->dbwidth()];
-	for(unsigned int i=0; i < this->dbwidth(); i++)
-	{
-		blocks_[i] = new gridmap*[this->dbheight()];
-		for(unsigned int j=0; j < this->dbheight(); j++)
-		{
-			unsigned int blockwidth = BLOCKSIZE;
-			if((i*BLOCKSIZE+blockwidth) > header_->width_)
-			{
-				blockwidth = header_->width_ % BLOCKSIZE;
-			}
-
-			unsigned int blockheight = BLOCKSIZE;
-			if((i*BLOCKSIZE+blockheight) > header_->height_)
-			{
-				blockheight = header_->height_ % BLOCKSIZE;
-			}
-
-			blocks_[i][j] = new gridmap(blockheight, blockwidth);
-		}
-	}
+	this->header_ = parser.get_header();
 
-	// set terrain type of each tile
-	for(unsigned int i=0; i < parser.get_num_tiles(); i++)
+	init_db();
+	// populate matrix
+	for(unsigned int i = 0; i < parser.get_num_tiles(); i++)
 	{
 		char c = parser.get_tile_at(i);
-		unsigned int x = i % this->width();
-		unsigned int y = i / this->width();
-
 		switch(c)
 		{
 			case 'S':
-			case 'W': 
+			case 'W':
 			case 'T':
 			case '@':
-			case 'O':
-				this->set_label(x, y, false); // obstacle
+			case 'O': // these terrain types are obstacles
+				this->set_label(to_padded_id(i), 0);
+				assert(this->get_label(to_padded_id(i)) == 0);
 				break;
-			default:
-				this->set_label(x, y, true); // traversable
+			default: // everything else is traversable
+				this->set_label(to_padded_id(i), 1);
+				assert(this->get_label(to_padded_id(i)) == 1);
 				break;
 		}
 	}
 }
 
-warthog::blockmap::~blockmap()
+void
+warthog::blockmap::init_db()
 {
-	for(unsigned int i = 0; i < this->dbwidth(); i++)
+	// one padded row (column) on either side of the map; then round up
+	// to whole blocks
+	blocks_per_row_ = (header_.width_ + 2 + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+	uint32_t block_rows =
+		(header_.height_ + 2 + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT;
+	padded_width_ = blocks_per_row_ * BLOCK_WIDTH;
+	padded_height_ = block_rows * BLOCK_HEIGHT;
+	row_stride_ = blocks_per_row_ * BLOCK_TILES;
+	db_size_ = padded_width_ * padded_height_ / 64;
+
+	// the words are surrounded by a block of zeroes on each side, for
+	// reads which cross into the next (or previous) block. the store
+	// is aligned so that every block fills a single cache line
+	store_ = new uint64_t[db_size_ + 2*GUARD + BLOCK_HEIGHT];
+	for(uint32_t i = 0; i < db_size_ + 2*GUARD + BLOCK_HEIGHT; i++)
 	{
-		for(unsigned int j = 0; j < this->dbheight(); j++)
-		{
-			delete blocks_[i][j];
-		}
-		delete [] blocks_[i];
+		store_[i] = 0;
 	}
-	delete [] blocks_;
-	delete header_;
+	uintptr_t align = sizeof(uint64_t) * BLOCK_HEIGHT;
+	uintptr_t first = ((uintptr_t)store_ + align - 1) & ~(align - 1);
+	db_ = (uint64_t*)first + GUARD;
+
+	max_id_ = db_size_-1;
+}
+
+warthog::blockmap::~blockmap()
+{
+	delete [] store_;
 }
 
-void 
+void
 warthog::blockmap::print(std::ostream& out)
 {
-	for(unsigned int y = 0; y < this->height(); y++)
+	out << "printing padded map" << std::endl;
+	out << "-------------------" << std::endl;
+	out << "type "<< header_.type_ << std::endl;
+	out << "height "<< this->height() << std::endl;
+	out << "width "<< this->width() << std::endl;
+	out << "map" << std::endl;
+	for(uint32_t y = 0; y < this->height(); y++)
 	{
-		for(unsigned int x = 0; x < this->width(); x++)
+		for(uint32_t x = 0; x < this->width(); x++)
 		{
-			out << this->get_label(x, y);
+			out << (this->get_label(x, y) ? '.' : '@');
 		}
 		out << std::endl;
 	}
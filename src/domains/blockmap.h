@@ -3,83 +3,291 @@
 
 // blockmap.h
 //
-// A blockmap is a division of gridmap into a set of rectangular blocks.
-// The idea is to create a cache-efficient method for accessing sections
-// of very large grid domains.
+// A uniform cost gridmap that is divided into rectangular blocks, for
+// cache-efficient access to very large grid domains. It offers the same
+// interface as warthog::gridmap (get_neighbours, get_neighbours_32bit,
+// to_padded_id, get_label etc) and can replace it in the expansion
+// policies which are parameterised by their map type (e.g.
+// gridmap_expansion_policy_t).
+//
+// Each block holds 8 rows of 64 tiles: one 64 bit word per row, 64 bytes
+// (a cache line) per block. Blocks are stored one row of blocks after
+// the other. In a row-major gridmap the 3x3 square around a tile spans
+// three rows, i.e. three cache lines that are far apart on large maps;
+// here it usually lies within a single block. The same holds for the
+// search nodes of nearby tiles, since node pools are indexed by id.
+//
+// Ids (padded ids) number the tiles in the order in which they are
+// stored: tile (x, y) of block (bx, by) has id
+// 512 * (by * blocks per row + bx) + 64 * (y % 8) + (x % 64).
+// Thus ids are not row-major: use ::get_neighbour_id to move between
+// tiles and ::to_padded_xy to recover coordinates. As with
+// warthog::gridmap, tile i is bit (i % 64) of word (i / 64).
+//
+// The map is padded with a row of obstacles above and below and a column
+// of obstacles to the left and right so that every tile of the map has
+// eight neighbours.
+//
+// Thread safety: as per warthog::gridmap.
 //
 // @author: dharabor
 // @created: 13/08/2012
 //
 
 #include "constants.h"
-#include "gridmap.h"
+#include "gm_parser.h"
 
 #include <iostream>
+#include <stdint.h>
 
 namespace warthog
 {
-	
-// blockmap constants
-static const unsigned int BLOCKSIZE = 256; // NB: must be a power of 2!!
-static const unsigned int LOG_BLOCKSIZE = ceil(log10(BLOCKSIZE) / log10(2));
 
-class gm_parser;
-class gridmap;
 class blockmap
 {
 	public:
+		// each block holds BLOCK_HEIGHT rows of BLOCK_WIDTH tiles
+		static const uint32_t BLOCK_WIDTH = 64;
+		static const uint32_t BLOCK_HEIGHT = 8;
+		static const uint32_t BLOCK_TILES = BLOCK_WIDTH * BLOCK_HEIGHT;
+		static const uint32_t LOG2_BLOCK_TILES = 9;
+
+		blockmap(uint32_t height, uint32_t width);
 		blockmap(const char* filename);
-		virtual ~blockmap();
+		~blockmap();
+
+		// here we convert from the coordinate space of
+		// the original grid to the coordinate space of db_.
+		inline uint32_t
+		to_padded_id(uint32_t node_id)
+		{
+			return to_padded_id(
+					node_id % header_.width_, node_id / header_.width_);
+		}
 
-		void print(std::ostream& out);
+		// as above, for the (unpadded) tile (x, y)
+		inline uint32_t
+		to_padded_id(uint32_t x, uint32_t y)
+		{
+			return padded_xy_to_id(x + 1, y + 1);
+		}
+
+		inline void
+		to_unpadded_xy(uint32_t padded_id, uint32_t& x, uint32_t& y)
+		{
+			to_padded_xy(padded_id, x, y);
+			x -= 1;
+			y -= 1;
+		}
+
+		inline void
+		to_padded_xy(uint32_t padded_id, uint32_t& x, uint32_t& y)
+		{
+			uint32_t block = padded_id >> LOG2_BLOCK_TILES;
+			uint32_t by = block / blocks_per_row_;
+			uint32_t bx = block - by * blocks_per_row_;
+			x = bx * BLOCK_WIDTH + (padded_id & (BLOCK_WIDTH-1));
+			y = by * BLOCK_HEIGHT +
+				((padded_id >> 6) & (BLOCK_HEIGHT-1));
+		}
 
+		// @return the id of the tile @param dx columns east and @param dy
+		// rows south of @param padded_id (dx and dy are -1, 0 or 1).
+		inline uint32_t
+		get_neighbour_id(uint32_t padded_id, int32_t dx, int32_t dy)
+		{
+			uint32_t col = padded_id & (BLOCK_WIDTH-1);
+			uint32_t row = padded_id & ((BLOCK_HEIGHT-1) << 6);
+			if(dx == 1)
+			{
+				padded_id += (col != BLOCK_WIDTH-1) ?
+					1 : BLOCK_TILES - (BLOCK_WIDTH-1);
+			}
+			else if(dx == -1)
+			{
+				padded_id -= col ? 1 : BLOCK_TILES - (BLOCK_WIDTH-1);
+			}
+			if(dy == 1)
+			{
+				padded_id += (row != ((BLOCK_HEIGHT-1) << 6)) ?
+					BLOCK_WIDTH : row_stride_ - ((BLOCK_HEIGHT-1) << 6);
+			}
+			else if(dy == -1)
+			{
+				padded_id -= row ?
+					BLOCK_WIDTH : row_stride_ - ((BLOCK_HEIGHT-1) << 6);
+			}
+			return padded_id;
+		}
+
+		// get the immediately adjacent neighbours of @param padded_id,
+		// as per gridmap::get_neighbours: the row above in @param
+		// tiles[0], the same row in tiles[1], the row below in tiles[2].
+		// position :0 is the nei in direction NW, :1 is N and :2 is NE
+		inline void
+		get_neighbours(uint32_t padded_id, uint8_t tiles[3])
+		{
+			tiles[0] = read_3bit(get_neighbour_id(padded_id, 0, -1));
+			tiles[1] = read_3bit(padded_id);
+			tiles[2] = read_3bit(get_neighbour_id(padded_id, 0, 1));
+		}
+
+		// as per gridmap::get_neighbours_32bit: 32 tiles from each of three
+		// adjacent rows; padded_id is in the lowest bit position of
+		// tiles[1]
+		inline void
+		get_neighbours_32bit(uint32_t padded_id, uint32_t tiles[3])
+		{
+			tiles[0] = (uint32_t)read_64bit(get_neighbour_id(padded_id, 0, -1));
+			tiles[1] = (uint32_t)read_64bit(padded_id);
+			tiles[2] = (uint32_t)read_64bit(get_neighbour_id(padded_id, 0, 1));
+		}
+
+		// get the label associated with the padded coordinate pair (x, y)
 		inline bool
-		get_label(unsigned int x, unsigned int y)
+		get_label(uint32_t x, uint32_t y)
 		{
-			unsigned int block_x = x >> warthog::LOG_BLOCKSIZE;
-			unsigned int block_y = y >> warthog::LOG_BLOCKSIZE;
-			x = x & (warthog::BLOCKSIZE-1);
-			y = y & (warthog::BLOCKSIZE-1);
-			gridmap* block = blocks_[block_x][block_y];
-			return block->get_label(block->to_padded_id(x, y));
+			if(x >= padded_width_ || y >= padded_height_) { return 0; }
+			return get_label(padded_xy_to_id(x, y));
 		}
 
-		inline void 
-		set_label(unsigned int x, unsigned int y, bool label)
+		inline warthog::dbword
+		get_label(uint32_t padded_id)
 		{
-			unsigned int block_x = x >> warthog::LOG_BLOCKSIZE;
-			unsigned int block_y = y >> warthog::LOG_BLOCKSIZE;
-			x = x & (warthog::BLOCKSIZE-1);
-			y = y & (warthog::BLOCKSIZE-1);
-			gridmap* block = blocks_[block_x][block_y];
-			return block->set_label(block->to_padded_id(x, y), label);
+			uint32_t dbindex = padded_id >> 6;
+			if(dbindex > max_id_) { return 0; }
+			return (db_[dbindex] >> (padded_id & 63)) & 1;
 		}
 
-		inline unsigned int height() { return header_->height_; }
-		inline unsigned int width() { return header_->width_; }
+		// set the label associated with the padded coordinate pair (x, y)
+		inline void
+		set_label(uint32_t x, uint32_t y, bool label)
+		{
+			if(x >= padded_width_ || y >= padded_height_) { return; }
+			set_label(padded_xy_to_id(x, y), label);
+		}
 
-		inline unsigned int 
-		get_num_blocks() 
-		{ 
-			return this->dbheight()*this->dbwidth(); 
+		inline void
+		set_label(uint32_t padded_id, bool label)
+		{
+			uint64_t bitmask = (uint64_t)1 << (padded_id & 63);
+			uint32_t dbindex = padded_id >> 6;
+			if(dbindex > max_id_) { return; }
+			if(label) { db_[dbindex] |= bitmask; }
+			else { db_[dbindex] &= ~bitmask; }
+		}
+
+		// NB: every padded id is smaller than height() * width()
+		inline uint32_t
+		padded_mapsize()
+		{
+			return padded_width_ * padded_height_;
+		}
+
+		inline uint32_t
+		height() const
+		{
+			return this->padded_height_;
+		}
+
+		inline uint32_t
+		width() const
+		{
+			return this->padded_width_;
+		}
+
+		inline uint32_t
+		header_height()
+		{
+			return this->header_.height_;
+		}
+
+		inline uint32_t
+		header_width()
+		{
+			return this->header_.width_;
+		}
+
+		inline const char*
+		filename()
+		{
+			return this->filename_;
+		}
+
+		inline uint32_t
+		get_num_blocks()
+		{
+			return blocks_per_row_ * (padded_height_ / BLOCK_HEIGHT);
+		}
+
+		void
+		print(std::ostream& out);
+
+		uint32_t
+		mem()
+		{
+			return sizeof(*this) +
+				sizeof(uint64_t) * (db_size_ + 2*GUARD + BLOCK_HEIGHT);
 		}
 
 	private:
-		inline unsigned int dbheight()
+		// blocks of zeroes before and after the map (see ::read_64bit)
+		static const uint32_t GUARD = BLOCK_HEIGHT;
+
+		warthog::gm_header header_;
+		uint64_t* db_; // every word is one row of one block
+		uint64_t* store_; // db_ and the guards around it
+		char filename_[256];
+
+		uint32_t db_size_; // in words
+		uint32_t padded_width_;
+		uint32_t padded_height_;
+		uint32_t blocks_per_row_;
+		uint32_t row_stride_; // ids per row of blocks
+		uint32_t max_id_;
+
+		blockmap(const warthog::blockmap& other) {}
+		blockmap& operator=(const warthog::blockmap& other) { return *this; }
+		void init_db();
+
+		inline uint32_t
+		padded_xy_to_id(uint32_t x, uint32_t y)
 		{
-			return (header_->height_ >> warthog::LOG_BLOCKSIZE)+1;
+			return (y / BLOCK_HEIGHT) * row_stride_ +
+				(x / BLOCK_WIDTH) * BLOCK_TILES +
+				(y % BLOCK_HEIGHT) * BLOCK_WIDTH + (x % BLOCK_WIDTH);
 		}
 
-		inline unsigned int dbwidth()
+		// @return the tiles to the west of, at and to the east of
+		// @param padded_id in the three lowest bits
+		inline uint8_t
+		read_3bit(uint32_t padded_id)
 		{
-			return (header_->width_ >> warthog::LOG_BLOCKSIZE)+1;
+			uint32_t col = padded_id & 63;
+			const uint64_t* word = db_ + (padded_id >> 6);
+			if(col - 1 < 62) { return (uint8_t)((*word >> (col - 1)) & 7); }
+
+			// the west or east tile is in the block next door
+			if(col == 0)
+			{
+				return (uint8_t)(((*word << 1) & 6) |
+						(word[-(int32_t)BLOCK_HEIGHT] >> 63));
+			}
+			return (uint8_t)((*word >> 62) | ((word[BLOCK_HEIGHT] & 1) << 2));
 		}
 
-		gm_header* header_;
-		gridmap*** blocks_; // gridmap* matrix; each BLOCKSIZE*BLOCKSIZE cells
+		// @return the 64 tiles that begin with @param padded_id, in the
+		// same row; padded_id is in the lowest bit position
+		inline uint64_t
+		read_64bit(uint32_t padded_id)
+		{
+			uint32_t col = padded_id & 63;
+			const uint64_t* word = db_ + (padded_id >> 6);
+			if(col == 0) { return *word; }
+			return (*word >> col) | (word[BLOCK_HEIGHT] << (64 - col));
+		}
 };
 
 }
 
 #endif
-
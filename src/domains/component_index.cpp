@@ -0,0 +1,183 @@
+#include "component_index.h"
+#include "gridmap.h"
+#include "weighted_gridmap.h"
+
+#include <algorithm>
+
+warthog::component_index::component_index(warthog::gridmap* map)
+	: gm_(map), wgm_(0)
+{
+	init(map->height(), map->width());
+}
+
+warthog::component_index::component_index(warthog::weighted_gridmap* map)
+	: gm_(0), wgm_(map)
+{
+	init(map->height(), map->width());
+}
+
+warthog::component_index::~component_index()
+{
+	delete [] comp_;
+}
+
+void
+warthog::component_index::init(uint32_t height, uint32_t width)
+{
+	width_ = width;
+	size_ = (size_t)height * width;
+	comp_ = new uint32_t[size_];
+	for(size_t i = 0; i < size_; i++) { comp_[i] = NONE; }
+
+	for(size_t i = 0; i < size_; i++)
+	{
+		if(comp_[i] == NONE && traversable(i)) { flood(i); }
+	}
+}
+
+bool
+warthog::component_index::traversable(warthog::sn_id_t id)
+{
+	if(gm_) { return gm_->get_label(id); }
+	return wgm_->get_label(id) != 0;
+}
+
+uint32_t
+warthog::component_index::new_component()
+{
+	uint32_t c = parent_.size();
+	parent_.push_back(c);
+	csize_.push_back(0);
+	return c;
+}
+
+void
+warthog::component_index::flood(warthog::sn_id_t id)
+{
+	uint32_t c = new_component();
+	comp_[id] = c;
+	stack_.clear();
+	stack_.push_back(id);
+	while(stack_.size())
+	{
+		warthog::sn_id_t cur = stack_.back();
+		stack_.pop_back();
+		csize_[c]++;
+
+		// NB: the padding around the map is never traversable
+		warthog::sn_id_t neis[4] =
+			{ cur - width_, cur + 1, cur + width_, cur - 1 };
+		for(uint32_t i = 0; i < 4; i++)
+		{
+			warthog::sn_id_t n = neis[i];
+			if(comp_[n] != c && traversable(n))
+			{
+				comp_[n] = c;
+				stack_.push_back(n);
+			}
+		}
+	}
+}
+
+uint32_t
+warthog::component_index::find(uint32_t c)
+{
+	uint32_t root = c;
+	while(parent_[root] != root) { root = parent_[root]; }
+	while(parent_[c] != root)
+	{
+		uint32_t next = parent_[c];
+		parent_[c] = root;
+		c = next;
+	}
+	return root;
+}
+
+void
+warthog::component_index::unite(uint32_t a, uint32_t b)
+{
+	a = find(a);
+	b = find(b);
+	if(a == b) { return; }
+	if(csize_[a] < csize_[b]) { std::swap(a, b); }
+	parent_[b] = a;
+	csize_[a] += csize_[b];
+}
+
+void
+warthog::component_index::set_label(warthog::sn_id_t id,
+		warthog::dbword label)
+{
+	bool was_traversable = traversable(id);
+	if(gm_) { gm_->set_label(id, label); }
+	else { wgm_->set_label(id, label); }
+	bool is_traversable = traversable(id);
+	if(was_traversable == is_traversable) { return; }
+
+	// straight neighbours in clockwise order (N, E, S, W), and the
+	// corner tile between each one and the next (NE, SE, SW, NW)
+	warthog::sn_id_t neis[4] = { id - width_, id + 1, id + width_, id - 1 };
+	warthog::sn_id_t corners[4] =
+		{ id - width_ + 1, id + width_ + 1, id + width_ - 1, id - width_ - 1 };
+
+	if(is_traversable)
+	{
+		uint32_t c = new_component();
+		csize_[c] = 1;
+		comp_[id] = c;
+		for(uint32_t i = 0; i < 4; i++)
+		{
+			if(traversable(neis[i])) { unite(c, comp_[neis[i]]); }
+		}
+		return;
+	}
+
+	uint32_t root = find(comp_[id]);
+	comp_[id] = NONE;
+	csize_[root]--;
+
+	// group the remaining neighbours which are (still) connected by a
+	// path around the removed tile
+	bool open[4];
+	uint32_t num_open = 0;
+	for(uint32_t i = 0; i < 4; i++)
+	{
+		open[i] = traversable(neis[i]);
+		num_open += open[i];
+	}
+	if(num_open <= 1) { return; }
+
+	uint32_t first = 0;
+	while(!open[first]) { first++; }
+	uint32_t num_groups = 0;
+	bool linked[4];
+	for(uint32_t i = 0; i < 4; i++)
+	{
+		uint32_t j = (i + 1) & 3;
+		linked[i] = open[i] && open[j] && traversable(corners[i]);
+	}
+	for(uint32_t i = 0; i < 4; i++)
+	{
+		// a group starts at every open neighbour not linked to the last
+		if(open[i] && !linked[(i + 3) & 3]) { num_groups++; }
+	}
+	if(num_groups <= 1) { return; }
+
+	// the component may have split. relabel every piece reachable from
+	// a neighbour, except the piece that contains the first one.
+	uint32_t num_new = parent_.size();
+	for(uint32_t i = first + 1; i < 4; i++)
+	{
+		if(!open[i] || comp_[neis[i]] >= num_new) { continue; }
+		flood(neis[i]);
+		csize_[root] -= csize_[parent_.size()-1];
+	}
+}
+
+size_t
+warthog::component_index::mem()
+{
+	return sizeof(*this) + size_ * sizeof(uint32_t) +
+		(parent_.capacity() + csize_.capacity()) * sizeof(uint32_t) +
+		stack_.capacity() * sizeof(warthog::sn_id_t);
+}
@@ -0,0 +1,130 @@
+#ifndef WARTHOG_COMPONENT_INDEX_H
+#define WARTHOG_COMPONENT_INDEX_H
+
+// component_index.h
+//
+// Labels every traversable tile of a grid map with the connected component
+// it belongs to, so that queries between different components can be
+// rejected without search.
+//
+// Both warthog::gridmap_expansion_policy and
+// warthog::wgridmap_expansion_policy forbid corner cutting: a diagonal move
+// requires both of the adjacent straight moves to be possible. Components
+// are therefore the sets of tiles connected by straight (4-connected)
+// moves; on a weighted_gridmap every tile with a non-zero label is
+// traversable.
+//
+// The index is built with one flood fill per component and then kept up
+// to date by ::set_label, which changes the label of a tile in the map
+// and repairs the index:
+//  - a new traversable tile merges the components of its neighbours.
+//    components are kept in a union-find structure (union by size) so
+//    merges take constant time (amortised).
+//  - a new obstacle may split its component. if the traversable neighbours
+//    of the tile remain connected by the 3x3 square around it, nothing
+//    changes; otherwise every piece except the first is relabelled with a
+//    flood fill.
+//
+// Thread safety: ::reachable and ::get_component only read the index and
+// can be called concurrently; ::set_label must not run at the same time.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class weighted_gridmap;
+
+class component_index
+{
+	public:
+		// the component of an obstacle
+		static const uint32_t NONE = 0xffffffff;
+
+		component_index(warthog::gridmap* map);
+		component_index(warthog::weighted_gridmap* map);
+		~component_index();
+
+		// @return the component of the tile with (padded) id @param id,
+		// or ::NONE if the tile is an obstacle
+		inline uint32_t
+		get_component(warthog::sn_id_t id)
+		{
+			uint32_t c = comp_[id];
+			if(c == NONE) { return NONE; }
+			while(parent_[c] != c) { c = parent_[c]; }
+			return c;
+		}
+
+		// @return false if there is certainly no path from @param from to
+		// @param to; i.e. either tile is an obstacle or the two are in
+		// different components. ids that are not tiles of the map (e.g.
+		// warthog::INF, which is used for searches without a goal) are
+		// never rejected.
+		inline bool
+		reachable(warthog::sn_id_t from, warthog::sn_id_t to)
+		{
+			if(from >= size_ || to >= size_) { return true; }
+			uint32_t c = get_component(from);
+			return c != NONE && c == get_component(to);
+		}
+
+		// set the label of tile @param id in the map and update the index
+		void
+		set_label(warthog::sn_id_t id, warthog::dbword label);
+
+		// the number of components ever created, including those that were
+		// since merged or split
+		inline uint32_t
+		num_labels() { return parent_.size(); }
+
+		size_t
+		mem();
+
+	private:
+		// exactly one of these is set
+		warthog::gridmap* gm_;
+		warthog::weighted_gridmap* wgm_;
+
+		size_t size_; // tiles in the padded map
+		uint32_t width_; // of the padded map
+		uint32_t* comp_; // for each tile: a component (not necessarily a root)
+		std::vector<uint32_t> parent_;
+		std::vector<uint32_t> csize_; // tiles in each component (roots only)
+		std::vector<warthog::sn_id_t> stack_;
+
+		// no copy
+		component_index(const component_index& other) { }
+		component_index&
+		operator=(const component_index& other) { return *this; }
+
+		void
+		init(uint32_t height, uint32_t width);
+
+		bool
+		traversable(warthog::sn_id_t id);
+
+		uint32_t
+		new_component();
+
+		// label every tile connected to @param id with a new component
+		void
+		flood(warthog::sn_id_t id);
+
+		void
+		unite(uint32_t a, uint32_t b);
+
+		uint32_t
+		find(uint32_t c);
+};
+
+}
+
+#endif
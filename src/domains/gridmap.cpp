@@ -1,16 +1,47 @@
 #include "gm_parser.h"
 #include "gridmap.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
-warthog::gridmap::gridmap(unsigned int h, unsigned int w)
+namespace
+{
+
+// transpose a 64x64 matrix of bits in place: bit j of a[i] trades places
+// with bit i of a[j]. round by round, the off-diagonal blocks of every 2x2
+// arrangement of 32x32, 16x16, .. 1x1 blocks are swapped; every round is 
+// 32 independent word operations on runs of consecutive words, which the
+// compiler vectorises [Warren H., Hacker's Delight, 2nd ed, 7-3]
+void
+transpose64(uint64_t a[64])
+{
+	uint64_t m = 0x00000000FFFFFFFFULL;
+	for(uint32_t j = 32; j != 0; j >>= 1, m ^= (m << j))
+	{
+		for(uint32_t base = 0; base < 64; base += 2*j)
+		{
+			for(uint32_t k = base; k < base + j; k++)
+			{
+				uint64_t t = ((a[k] >> j) ^ a[k + j]) & m;
+				a[k] ^= t << j;
+				a[k + j] ^= t;
+			}
+		}
+	}
+}
+
+}
+
+template <class W>
+warthog::gridmap_t<W>::gridmap_t(unsigned int h, unsigned int w)
 	: header_(h, w, "octile")
 {	
 	this->init_db();
 }
 
-warthog::gridmap::gridmap(const char* filename)
+template <class W>
+warthog::gridmap_t<W>::gridmap_t(const char* filename)
 {
 	strcpy(filename_, filename);
 	warthog::gm_parser parser(filename);
@@ -39,8 +70,9 @@ warthog::gridmap::gridmap(const char* filename)
 	}
 }
 
+template <class W>
 void
-warthog::gridmap::init_db()
+warthog::gridmap_t<W>::init_db()
 {
 	// when storing the grid we pad the edges of the map with
 	// zeroes. this eliminates the need for bounds checking when
@@ -50,32 +82,127 @@ warthog::gridmap::init_db()
 	this->dbheight_ = this->header_.height_ + 
 		padded_rows_after_last_row_ +
 		padded_rows_before_first_row_;
-	this->dbwidth_  = (this->header_.width_ >> warthog::LOG2_DBWORD_BITS) + 1;
+	this->dbwidth_  = (this->header_.width_ >> LOG2_WORD_BITS) + 1;
+
+	// rows are at least 64 tiles wide. together with the padded rows
+	// this keeps every 64 bit read (see ::read_64bit) inside the map.
+	if(this->dbwidth_ * WORD_BITS < 64) { this->dbwidth_ = 64 / WORD_BITS; }
 
 	// calculate # of extra/redundant padding bits required,
-	// per row, to align map width with dbword size
+	// per row, to align map width with word size
 	this->padded_height_ = this->dbheight_;
-	this->padded_width_ = (this->dbwidth_ * warthog::DBWORD_BITS);
+	this->padded_width_ = (this->dbwidth_ * WORD_BITS);
+	this->rowbytes_ = this->padded_width_ / 8;
 	this->padding_per_row_ = this->padded_width_ - this->header_.width_;
 	this->db_size_ = this->dbwidth_ * this->dbheight_;
 
-	// create a one dimensional dbword array to store the grid
-	this->db_ = new warthog::dbword[db_size_];
-	for(unsigned int i=0; i < db_size_; i++)
+	// create a one dimensional array of words to store the grid. the
+	// array is surrounded by GUARD_BYTES of zeroes so that wide reads
+	// (see ::get_words64) near the edges of the map stay inside it.
+	uint32_t guard = GUARD_BYTES / sizeof(W);
+	this->store_ = new W[db_size_ + 2*guard];
+	for(unsigned int i=0; i < db_size_ + 2*guard; i++)
 	{
-		db_[i] = 0;
+		store_[i] = 0;
 	}
+	this->db_ = store_ + guard;
 
 	max_id_ = db_size_-1;
+	rotated_ = 0;
 }
 
-warthog::gridmap::~gridmap()
+template <class W>
+warthog::gridmap_t<W>::~gridmap_t()
 {
-	delete [] db_;
+	delete rotated_.load();
+	delete [] store_;
 }
 
+template <class W>
+warthog::gridmap_t<W>*
+warthog::gridmap_t<W>::rotated()
+{
+	std::call_once(rotated_once_, &warthog::gridmap_t<W>::rotate, this);
+	return rotated_;
+}
+
+// the map is cut into blocks of 64x64 tiles. block (c, k) holds the tiles
+// x = 64c .. 64c+63 of the rows y = h-1-64k .. h-64-64k (h is the height 
+// of the map), taken bottom to top. transposed, the block holds the tiles
+// rx = 64k .. 64k+63 of the rows ry = 64c .. 64c+63 of the rotated map.
+template <class W>
+void
+warthog::gridmap_t<W>::rotate()
+{
+	uint32_t maph = header_.height_;
+	uint32_t mapw = header_.width_;
+	warthog::gridmap_t<W>* rmap = new warthog::gridmap_t<W>(mapw, maph);
+	uint8_t* rbytes = (uint8_t*)rmap->db_;
+
+	uint64_t block[64];
+	for(uint32_t c = 0; c*64 < mapw; c++)
+	{
+		// tiles past the end of a row are padding, or even (with words
+		// of less than 64 bits) tiles of the next row
+		uint32_t cols = std::min<uint32_t>(64, mapw - c*64);
+		uint64_t mask = cols == 64 ? ~0ULL : (1ULL << cols) - 1;
+		for(uint32_t k = 0; k*64 < maph; k++)
+		{
+			for(uint32_t i = 0; i < 64; i++)
+			{
+				int32_t y = (int32_t)maph - 1 - (int32_t)(k*64 + i);
+				block[i] = y < 0 ? 0 : mask & read_64bit(
+					(y + padded_rows_before_first_row_)*padded_width_ + c*64);
+			}
+			transpose64(block);
+
+			// rows of the rotated map begin on a byte boundary. the tiles
+			// past the end of a row are zero, so they can spill into 
+			// the next row unharmed
+			for(uint32_t j = 0; j < cols; j++)
+			{
+				uint32_t rid = (c*64 + j + rmap->padded_rows_before_first_row_)
+					* rmap->padded_width_ + k*64;
+				uint64_t word;
+				memcpy(&word, rbytes + (rid >> 3), sizeof(word));
+				word |= block[j];
+				memcpy(rbytes + (rid >> 3), &word, sizeof(word));
+			}
+		}
+	}
+	rotated_.store(rmap, std::memory_order_release);
+}
+
+template <class W>
+void
+warthog::gridmap_t<W>::set_rotated_label(uint32_t padded_id, bool label)
+{
+	// NB: tiles of the padding have no counterpart
+	uint32_t x = padded_id % padded_width_;
+	uint32_t y = padded_id / padded_width_ - padded_rows_before_first_row_;
+	if(x >= header_.width_ || y >= header_.height_) { return; }
+
+	warthog::gridmap_t<W>* rmap = rotated_.load(std::memory_order_acquire);
+	rmap->set_label(rmap->to_padded_id(header_.height_ - y - 1, x), label);
+}
+
+// NB: the hash is computed byte by byte, whatever the word size
+template <class W>
+uint32_t
+warthog::gridmap_t<W>::checksum()
+{
+	const uint8_t* bytes = (const uint8_t*)db_;
+	uint32_t hash = warthog::FNV32_offset_basis;
+	for(uint32_t i = 0; i < db_size_ * sizeof(W); i++)
+	{
+		hash = (hash ^ bytes[i]) * warthog::FNV32_prime;
+	}
+	return hash;
+}
+
+template <class W>
 void 
-warthog::gridmap::print(std::ostream& out)
+warthog::gridmap_t<W>::print(std::ostream& out)
 {
 	out << "printing padded map" << std::endl;
 	out << "-------------------" << std::endl;
@@ -93,3 +220,8 @@ warthog::gridmap::print(std::ostream& out)
 		out << std::endl;
 	}	
 }
+
+// the available word sizes
+template class warthog::gridmap_t<uint8_t>;
+template class warthog::gridmap_t<uint32_t>;
+template class warthog::gridmap_t<uint64_t>;
@@ -14,6 +14,21 @@
 // in a one dimensional array and also to avoid range checks when trying to 
 // identify invalid neighbours of tiles on the edge of the map.
 //
+// The map is parameterised by the type of word, W, that holds its tiles 
+// (uint8_t, uint32_t or uint64_t). Each row is padded to a whole number of
+// words, so every row begins on a word boundary, and is at least 64 tiles
+// wide. Bit i of the map is bit (i % 8) of byte (i / 8) whatever the word 
+// size (the map is little endian) so the methods which read tiles in 
+// bulk (get_neighbours_32bit, get_neighbours_64bit etc) work with any W; 
+// with 64 bit words every 64 bit read is aligned. warthog::gridmap uses 
+// 64 bit words.
+//
+// Thread safety: all const-style queries (get_label, get_neighbours,
+// to_padded_id etc) only read the map and can be called concurrently from 
+// any number of threads without locks. set_label is not synchronised: 
+// it must not run while other threads are reading the map (or the rotated
+// map, to which it is mirrored). ::rotated may be called from any thread.
+//
 // @author: dharabor
 // @created: 08/08/2012
 // 
@@ -22,18 +37,31 @@
 #include "helpers.h"
 #include "gm_parser.h"
 
+#include <atomic>
 #include <climits>
+#include <mutex>
 #include "stdint.h"
 
 namespace warthog
 {
 
-class gridmap
+// W is the type of word used to store the tiles of the map
+template <class W>
+class gridmap_t
 {
 	public:
-		gridmap(uint32_t height, unsigned int width);
-		gridmap(const char* filename);
-		~gridmap();
+		// the number of tiles in each word
+		static const uint32_t WORD_BITS = sizeof(W)*8;
+		static const uint32_t WORD_BITS_MASK = WORD_BITS-1;
+		static const uint32_t LOG2_WORD_BITS = 
+			sizeof(W) == 8 ? 6 : (sizeof(W) == 4 ? 5 : (sizeof(W) == 2 ? 4 : 3));
+
+		// zeroes before and after the map (see ::get_words64)
+		static const uint32_t GUARD_BYTES = 64;
+
+		gridmap_t(uint32_t height, unsigned int width);
+		gridmap_t(const char* filename);
+		~gridmap_t();
 
 		// here we convert from the coordinate space of 
 		// the original grid to the coordinate space of db_. 
@@ -70,6 +98,16 @@ class gridmap
 			x = padded_id % padded_width_;
 		}
 
+		// @return the id of the tile @param dx columns east and @param dy
+		// rows south of @param padded_id (dx and dy are -1, 0 or 1).
+		// same as padded_id + dy*width() + dx; see blockmap, whose ids 
+		// are not row-major
+		inline uint32_t
+		get_neighbour_id(uint32_t padded_id, int32_t dx, int32_t dy)
+		{
+			return padded_id + dy * (int32_t)padded_width_ + dx;
+		}
+
 		// get the immediately adjacent neighbours of @param node_id
 		// neighbours from the row above node_id are stored in 
 		// @param tiles[0], neighbours from the same row in tiles[1]
@@ -80,22 +118,23 @@ class gridmap
 		inline void
 		get_neighbours(uint32_t padded_id, uint8_t tiles[3])
 		{
-			// 1. calculate the dbword offset for the node at index padded_id
-			// 2. convert padded_id into a dbword index.
-			uint32_t bit_offset = (padded_id & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = padded_id >> warthog::LOG2_DBWORD_BITS;
+			// 1. calculate the bit offset for the node at index padded_id
+			// 2. convert padded_id into a byte index.
+			uint32_t bit_offset = (padded_id & 7);
+			uint32_t byteindex = padded_id >> 3;
 
-			// compute dbword indexes for tiles immediately above 
+			// compute byte indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			uint32_t pos1 = byteindex - rowbytes_;
+			uint32_t pos2 = byteindex;
+			uint32_t pos3 = byteindex + rowbytes_;
 
 			// read from the byte just before node_id and shift down until the
 			// nei adjacent to node_id is in the lowest position
-			tiles[0] = (uint8_t)(*((uint32_t*)(db_+(pos1-1))) >> (bit_offset+7));
-			tiles[1] = (uint8_t)(*((uint32_t*)(db_+(pos2-1))) >> (bit_offset+7));
-			tiles[2] = (uint8_t)(*((uint32_t*)(db_+(pos3-1))) >> (bit_offset+7));
+			const uint8_t* bytes = (const uint8_t*)db_;
+			tiles[0] = (uint8_t)(*((uint32_t*)(bytes+(pos1-1))) >> (bit_offset+7));
+			tiles[1] = (uint8_t)(*((uint32_t*)(bytes+(pos2-1))) >> (bit_offset+7));
+			tiles[2] = (uint8_t)(*((uint32_t*)(bytes+(pos3-1))) >> (bit_offset+7));
 		}
 
 		// fetches a contiguous set of tiles from three adjacent rows. each row is
@@ -104,22 +143,23 @@ class gridmap
 		void
 		get_neighbours_32bit(uint32_t padded_id, uint32_t tiles[3])
 		{
-			// 1. calculate the dbword offset for the node at index padded_id
-			// 2. convert padded_id into a dbword index.
-			uint32_t bit_offset = (padded_id & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = padded_id >> warthog::LOG2_DBWORD_BITS;
+			// 1. calculate the bit offset for the node at index padded_id
+			// 2. convert padded_id into a byte index.
+			uint32_t bit_offset = (padded_id & 7);
+			uint32_t byteindex = padded_id >> 3;
 
-			// compute dbword indexes for tiles immediately above 
+			// compute byte indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			uint32_t pos1 = byteindex - rowbytes_;
+			uint32_t pos2 = byteindex;
+			uint32_t pos3 = byteindex + rowbytes_;
 
 			// read 32bits of memory; padded_id is in the 
 			// lowest bit position of tiles[1]
-			tiles[0] = (uint32_t)(*((uint64_t*)(db_+pos1)) >> (bit_offset));
-			tiles[1] = (uint32_t)(*((uint64_t*)(db_+pos2)) >> (bit_offset));
-			tiles[2] = (uint32_t)(*((uint64_t*)(db_+pos3)) >> (bit_offset));
+			const uint8_t* bytes = (const uint8_t*)db_;
+			tiles[0] = (uint32_t)(*((uint64_t*)(bytes+pos1)) >> (bit_offset));
+			tiles[1] = (uint32_t)(*((uint64_t*)(bytes+pos2)) >> (bit_offset));
+			tiles[2] = (uint32_t)(*((uint64_t*)(bytes+pos3)) >> (bit_offset));
 		}
 
 		// similar to get_neighbours_32bit but padded_id is placed into the
@@ -128,26 +168,46 @@ class gridmap
 		inline void
 		get_neighbours_upper_32bit(uint32_t padded_id, uint32_t tiles[3])
 		{
-			// 1. calculate the dbword offset for the node at index padded_id
-			// 2. convert padded_id into a dbword index.
-			uint32_t bit_offset = (padded_id & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = padded_id >> warthog::LOG2_DBWORD_BITS;
+			// 1. calculate the bit offset for the node at index padded_id
+			// 2. convert padded_id into a byte index.
+			uint32_t bit_offset = (padded_id & 7);
+			uint32_t byteindex = padded_id >> 3;
 			
 			// start reading from a prior index. this way everything
 			// up to padded_id is cached.
-			dbindex -= 4;
+			byteindex -= 4;
 
-			// compute dbword indexes for tiles immediately above 
+			// compute byte indexes for tiles immediately above 
 			// and immediately below node_id
-			uint32_t pos1 = dbindex - dbwidth_;
-			uint32_t pos2 = dbindex;
-			uint32_t pos3 = dbindex + dbwidth_;
+			uint32_t pos1 = byteindex - rowbytes_;
+			uint32_t pos2 = byteindex;
+			uint32_t pos3 = byteindex + rowbytes_;
 
 			// read 32bits of memory; padded_id is in the 
 			// highest bit position of tiles[1]
-			tiles[0] = (uint32_t)(*((uint64_t*)(db_+pos1)) >> (bit_offset+1));
-			tiles[1] = (uint32_t)(*((uint64_t*)(db_+pos2)) >> (bit_offset+1));
-			tiles[2] = (uint32_t)(*((uint64_t*)(db_+pos3)) >> (bit_offset+1));
+			const uint8_t* bytes = (const uint8_t*)db_;
+			tiles[0] = (uint32_t)(*((uint64_t*)(bytes+pos1)) >> (bit_offset+1));
+			tiles[1] = (uint32_t)(*((uint64_t*)(bytes+pos2)) >> (bit_offset+1));
+			tiles[2] = (uint32_t)(*((uint64_t*)(bytes+pos3)) >> (bit_offset+1));
+		}
+
+		// as get_neighbours_32bit but each row is 64 tiles long
+		inline void
+		get_neighbours_64bit(uint32_t padded_id, uint64_t tiles[3])
+		{
+			tiles[0] = read_64bit(padded_id - padded_width_);
+			tiles[1] = read_64bit(padded_id);
+			tiles[2] = read_64bit(padded_id + padded_width_);
+		}
+
+		// as get_neighbours_upper_32bit but each row is 64 tiles long
+		inline void
+		get_neighbours_upper_64bit(uint32_t padded_id, uint64_t tiles[3])
+		{
+			padded_id -= 63;
+			tiles[0] = read_64bit(padded_id - padded_width_);
+			tiles[1] = read_64bit(padded_id);
+			tiles[2] = read_64bit(padded_id + padded_width_);
 		}
 
 		// get the label associated with the padded coordinate pair (x, y)
@@ -161,9 +221,9 @@ class gridmap
 		get_label(uint32_t padded_id)
 		{
 			// now we can fetch the label
-			warthog::dbword bitmask = 1;
-			bitmask <<= (padded_id & warthog::DBWORD_BITS_MASK);
-			uint32_t dbindex = padded_id >> warthog::LOG2_DBWORD_BITS;
+			W bitmask = 1;
+			bitmask <<= (padded_id & WORD_BITS_MASK);
+			uint32_t dbindex = padded_id >> LOG2_WORD_BITS;
 			if(dbindex > max_id_) { return 0; }
 			return (db_[dbindex] & bitmask) != 0;
 		}
@@ -178,9 +238,8 @@ class gridmap
 		inline void 
 		set_label(uint32_t padded_id, bool label)
 		{
-			warthog::dbword bitmask =
-				(1 << (padded_id & warthog::DBWORD_BITS_MASK));
-			uint32_t dbindex = padded_id >> warthog::LOG2_DBWORD_BITS;
+			W bitmask = (W)1 << (padded_id & WORD_BITS_MASK);
+			uint32_t dbindex = padded_id >> LOG2_WORD_BITS;
 			if(dbindex > max_id_) { return; }
 
 			if(label)
@@ -191,6 +250,10 @@ class gridmap
 			{
 				db_[dbindex] &= ~bitmask;
 			}
+			if(rotated_.load(std::memory_order_acquire))
+			{
+				set_rotated_label(padded_id, label);
+			}
 		}
 
 		inline uint32_t
@@ -229,26 +292,53 @@ class gridmap
 			return this->filename_;
 		}
 
+		// FNV-1a hash of the (padded) map data. Precomputed databases 
+		// store this value so they can detect when the map has changed.
+		uint32_t
+		checksum();
+
 		void 
 		print(std::ostream&);
 		
 		void
 		printdb(std::ostream& out);
 
+		// the map rotated by 90 degrees clockwise: tile (x, y) becomes 
+		// tile (header_height() - y - 1, x). the rows of the rotated map 
+		// are the columns of this one, so that jumps north and south can 
+		// scan whole words, as jumps east and west do (see 
+		// online_jump_point_locator). the rotated map is built on first
+		// use, 64x64 tiles at a time, and shared by all callers; it 
+		// belongs to this map. once built, it is kept up to date by 
+		// ::set_label.
+		warthog::gridmap_t<W>*
+		rotated();
+
+		// the tiles of the map viewed as an array of 64 bit words: tile 
+		// (padded id) i is bit (i % 64) of word (i / 64). reads may extend
+		// up to GUARD_BYTES before the first and after the last word.
+		inline const uint64_t*
+		get_words64() { return (const uint64_t*)db_; }
+
 		uint32_t 
 		mem()
 		{
+			warthog::gridmap_t<W>* rmap = 
+				rotated_.load(std::memory_order_acquire);
 			return sizeof(*this) +
-			sizeof(warthog::dbword) * db_size_;
+			sizeof(W) * (db_size_ + 2*(GUARD_BYTES / sizeof(W))) +
+			(rmap ? rmap->mem() : 0);
 		}
 
 
 	private:
 		warthog::gm_header header_;
-		warthog::dbword* db_;
+		W* db_;
+		W* store_; // db_ and the guards around it
 		char filename_[256];
 
 		uint32_t dbwidth_;
+		uint32_t rowbytes_;
 		uint32_t dbheight_;
 		uint32_t db_size_;
 		uint32_t padded_width_;
@@ -259,11 +349,37 @@ class gridmap
 		uint32_t padded_rows_after_last_row_;
 		uint32_t max_id_;
 
-		gridmap(const warthog::gridmap& other) {}
-		gridmap& operator=(const warthog::gridmap& other) { return *this; }
+		// set once, by ::rotate (i.e. under rotated_once_)
+		std::atomic<warthog::gridmap_t<W>*> rotated_;
+		std::once_flag rotated_once_;
+
+		gridmap_t(const warthog::gridmap_t<W>& other) {}
+		gridmap_t& operator=(const warthog::gridmap_t<W>& other) { return *this; }
 		void init_db();
+		void rotate();
+
+		// copy the label of tile @param padded_id to the rotated map
+		void set_rotated_label(uint32_t padded_id, bool label);
+
+		// @return the 64 tiles that begin with @param padded_id; 
+		// padded_id is in the lowest bit position. the two words read
+		// are aligned (the map is viewed as an array of 64 bit words)
+		inline uint64_t
+		read_64bit(uint32_t padded_id)
+		{
+			const uint64_t* words = (const uint64_t*)db_;
+			uint32_t index = padded_id >> 6;
+			__extension__ typedef unsigned __int128 uint128;
+			uint128 both = ((uint128)words[index+1] << 64) | words[index];
+			return (uint64_t)(both >> (padded_id & 63));
+		}
 };
 
+typedef gridmap_t<uint8_t> gridmap8;
+typedef gridmap_t<uint32_t> gridmap32;
+typedef gridmap_t<uint64_t> gridmap64;
+typedef gridmap64 gridmap;
+
 }
 
 #endif
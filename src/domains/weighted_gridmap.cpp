@@ -1,6 +1,7 @@
 #include "gm_parser.h"
 #include "weighted_gridmap.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -60,13 +61,65 @@ warthog::weighted_gridmap::init_db()
 	{
 		db_[i] = 0; 
 	}
+	rotated_ = 0;
 }
 
 warthog::weighted_gridmap::~weighted_gridmap()
 {
+	delete rotated_.load();
 	delete [] db_;
 }
 
+warthog::weighted_gridmap*
+warthog::weighted_gridmap::rotated()
+{
+	std::call_once(rotated_once_, &warthog::weighted_gridmap::rotate, this);
+	return rotated_;
+}
+
+// tiles are copied in blocks of 64x64, so that the rows read and the rows
+// written all stay in cache
+void
+warthog::weighted_gridmap::rotate()
+{
+	uint32_t maph = header_.height_;
+	uint32_t mapw = header_.width_;
+	warthog::weighted_gridmap* rmap = new warthog::weighted_gridmap(mapw, maph);
+	for(uint32_t y0 = 0; y0 < maph; y0 += 64)
+	{
+		uint32_t ymax = std::min(maph, y0 + 64);
+		for(uint32_t x0 = 0; x0 < mapw; x0 += 64)
+		{
+			uint32_t xmax = std::min(mapw, x0 + 64);
+			for(uint32_t x = x0; x < xmax; x++)
+			{
+				warthog::dbword* rrow = rmap->db_ + 
+					(x + rmap->padded_rows_before_first_row_) * 
+					rmap->padded_width_;
+				for(uint32_t y = y0; y < ymax; y++)
+				{
+					rrow[maph - 1 - y] = db_[x + 
+						(y + padded_rows_before_first_row_) * padded_width_];
+				}
+			}
+		}
+	}
+	rotated_.store(rmap, std::memory_order_release);
+}
+
+void
+warthog::weighted_gridmap::set_rotated_label(uint32_t padded_id, 
+		warthog::dbword label)
+{
+	// NB: tiles of the padding have no counterpart
+	uint32_t x = padded_id % padded_width_;
+	uint32_t y = padded_id / padded_width_ - padded_rows_before_first_row_;
+	if(x >= header_.width_ || y >= header_.height_) { return; }
+
+	warthog::weighted_gridmap* rmap = rotated_.load(std::memory_order_acquire);
+	rmap->set_label(rmap->to_padded_id(header_.height_ - y - 1, x), label);
+}
+
 void 
 warthog::weighted_gridmap::print(std::ostream& out)
 {
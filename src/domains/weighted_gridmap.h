@@ -18,7 +18,9 @@
 #include "helpers.h"
 #include "gm_parser.h"
 
+#include <atomic>
 #include <climits>
+#include <mutex>
 #include <stdint.h>
 
 namespace warthog
@@ -57,6 +59,21 @@ class weighted_gridmap
 			x = padded_id % padded_width_;
 		}
 
+		inline void
+		to_padded_xy(uint32_t padded_id, uint32_t& x, uint32_t& y)
+		{
+			y = padded_id / padded_width_;
+			x = padded_id % padded_width_;
+		}
+
+		// @return the id of the tile @param dx columns east and @param dy
+		// rows south of @param padded_id (dx and dy are -1, 0 or 1)
+		inline uint32_t
+		get_neighbour_id(uint32_t padded_id, int32_t dx, int32_t dy)
+		{
+			return padded_id + dy * (int32_t)padded_width_ + dx;
+		}
+
         // read all tiles in the 3x3 square centred on @param db_id
         // return: 
         //  @param ids stores the ids of all tiles
@@ -117,6 +134,10 @@ class weighted_gridmap
 		set_label(uint32_t padded_id, warthog::dbword label)
 		{
             db_[padded_id] = label;
+			if(rotated_.load(std::memory_order_acquire))
+			{
+				set_rotated_label(padded_id, label);
+			}
 		}
 
 		inline uint32_t 
@@ -149,14 +170,24 @@ class weighted_gridmap
 			return this->filename_;
 		}
 
+		// the map rotated by 90 degrees clockwise: tile (x, y) becomes 
+		// tile (header_height() - y - 1, x). built on first use, shared 
+		// by all callers and kept up to date by ::set_label (see 
+		// gridmap::rotated)
+		warthog::weighted_gridmap*
+		rotated();
+
 		void 
 		print(std::ostream&);
 		
 		uint32_t 
 		mem()
 		{
+			warthog::weighted_gridmap* rmap = 
+				rotated_.load(std::memory_order_acquire);
 			return sizeof(*this) +
-			sizeof(warthog::dbword) * db_size_;
+			sizeof(warthog::dbword) * db_size_ + 
+			(rmap ? rmap->mem() : 0);
 		}
 
 
@@ -172,10 +203,17 @@ class weighted_gridmap
 		uint32_t padded_rows_after_last_row_;
         uint32_t padded_width_;
         uint32_t padded_height_;
+		// set once, by ::rotate (i.e. under rotated_once_)
+		std::atomic<warthog::weighted_gridmap*> rotated_;
+		std::once_flag rotated_once_;
 
 		weighted_gridmap(const warthog::weighted_gridmap& other) {}
 		weighted_gridmap& operator=(const warthog::weighted_gridmap& other) { return *this; }
 		void init_db();
+		void rotate();
+
+		// copy the label of tile @param padded_id to the rotated map
+		void set_rotated_label(uint32_t padded_id, warthog::dbword label);
 };
 
 }
@@ -24,9 +24,9 @@ warthog::blocklist::~blocklist()
 }
 
 warthog::search_node*
-warthog::blocklist::generate(uint32_t node_id)
+warthog::blocklist::generate(warthog::sn_id_t node_id)
 {
-	uint32_t block_id = node_id >> warthog::blocklist_ns::LOG2_NBS;
+	warthog::sn_id_t block_id = node_id >> warthog::blocklist_ns::LOG2_NBS;
 	uint32_t list_id = node_id &  warthog::blocklist_ns::NBS_MASK;
 	assert(block_id <= num_blocks_);
 
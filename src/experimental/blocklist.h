@@ -46,7 +46,17 @@ class blocklist
 		// if the node has already been generated, return a pointer to the 
 		// previous instance; otherwise allocate memory for a new object.
 		warthog::search_node*
-		generate(uint32_t node_id);
+		generate(warthog::sn_id_t node_id);
+
+		// @return the node with the given id or null if the node has not
+		// been generated since the last call to ::clear
+		inline warthog::search_node*
+		find(warthog::sn_id_t node_id)
+		{
+			warthog::search_node** list =
+				blocks_[node_id >> warthog::blocklist_ns::LOG2_NBS];
+			return list ? list[node_id & warthog::blocklist_ns::NBS_MASK] : 0;
+		}
 
 		void
 		clear();
@@ -39,9 +39,9 @@ warthog::blocklist2::~blocklist2()
 }
 
 warthog::search_node*
-warthog::blocklist2::generate(uint32_t node_id)
+warthog::blocklist2::generate(warthog::sn_id_t node_id)
 {
-	uint32_t block_id = node_id >> warthog::blocklist2_ns::LOG2_NBS;
+	warthog::sn_id_t block_id = node_id >> warthog::blocklist2_ns::LOG2_NBS;
 	uint32_t list_id = node_id &  warthog::blocklist2_ns::NBS_MASK;
 	assert(block_id <= num_blocks_);
 
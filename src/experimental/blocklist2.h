@@ -44,7 +44,7 @@ class blocklist2
 		// if the node has already been generated, return a pointer to the 
 		// previous instance; otherwise allocate memory for a new object.
 		warthog::search_node*
-		generate(uint32_t node_id);
+		generate(warthog::sn_id_t node_id);
 
 		void
 		clear();
@@ -0,0 +1,48 @@
+#include "flat_nodepool.h"
+
+#include <cstring>
+#include <new>
+
+warthog::flat_nodepool::flat_nodepool(uint32_t mapheight, uint32_t mapwidth)
+	: num_nodes_(mapheight*mapwidth), generation_(1)
+{
+	nodes_ = static_cast<warthog::search_node*>(
+			::operator new(sizeof(warthog::search_node)*num_nodes_));
+	for(uint32_t i = 0; i < num_nodes_; i++)
+	{
+		new (&nodes_[i]) warthog::search_node(i);
+	}
+
+	stamps_ = new uint32_t[num_nodes_];
+	memset(stamps_, 0, sizeof(*stamps_)*num_nodes_);
+}
+
+warthog::flat_nodepool::~flat_nodepool()
+{
+	for(uint32_t i = 0; i < num_nodes_; i++)
+	{
+		nodes_[i].~search_node();
+	}
+	::operator delete(nodes_);
+	delete [] stamps_;
+}
+
+void
+warthog::flat_nodepool::clear()
+{
+	generation_++;
+	if(generation_ == 0)
+	{
+		// stamps wrapped around; make every node stale again
+		memset(stamps_, 0, sizeof(*stamps_)*num_nodes_);
+		generation_ = 1;
+	}
+}
+
+size_t
+warthog::flat_nodepool::mem()
+{
+	return sizeof(*this) + 
+		(size_t)num_nodes_*(sizeof(warthog::search_node) + sizeof(*stamps_));
+}
+
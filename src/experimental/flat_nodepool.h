@@ -0,0 +1,87 @@
+#ifndef WARTHOG_FLAT_NODEPOOL_H
+#define WARTHOG_FLAT_NODEPOOL_H
+
+// flat_nodepool.h
+//
+// A pool of warthog::search_node objects stored in a single flat array 
+// and indexed directly by node id. Every node is allocated up front, so 
+// ::generate is a single array lookup with no pointer chasing and no 
+// allocation during search.
+//
+// Nodes are reset lazily: a separate array records, for each node, the 
+// generation (i.e. the search) in which it was last reset. ::clear simply
+// starts a new generation and ::generate resets any node that is stale.
+// Keeping the stamps apart from the nodes means a new search touches only
+// the nodes it actually generates.
+//
+// Compared to warthog::blocklist this trades memory (sizeof(search_node) 
+// + 4 bytes for every tile of the padded map, traversable or not) for 
+// speed. It is best suited to small and medium maps and to dense 
+// searches (e.g. A* or Dijkstra) that generate many nodes.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "search_node.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace warthog
+{
+
+class flat_nodepool
+{
+	public:
+		flat_nodepool(uint32_t mapheight, uint32_t mapwidth);
+		~flat_nodepool();
+
+		// return the warthog::search_node object corresponding to the given 
+		// id. the node is reset if it was not generated since the last call 
+		// to ::clear.
+		inline warthog::search_node*
+		generate(warthog::sn_id_t node_id)
+		{
+			assert(node_id < num_nodes_);
+			warthog::search_node* mynode = &nodes_[node_id];
+			if(stamps_[node_id] != generation_)
+			{
+				mynode->reset(0);
+				stamps_[node_id] = generation_;
+			}
+			return mynode;
+		}
+
+		// @return the node with the given id or null if the node has not
+		// been generated since the last call to ::clear
+		inline warthog::search_node*
+		find(warthog::sn_id_t node_id)
+		{
+			assert(node_id < num_nodes_);
+			return stamps_[node_id] == generation_ ? &nodes_[node_id] : 0;
+		}
+
+		// discard all generated nodes; O(1) except every 2^32 calls
+		void
+		clear();
+
+		size_t
+		mem();
+
+	private:
+		uint32_t num_nodes_;
+		uint32_t generation_;
+		warthog::search_node* nodes_;
+		uint32_t* stamps_;
+
+		// no copy
+		flat_nodepool(const flat_nodepool& other) { }
+		flat_nodepool& 
+		operator=(const flat_nodepool& other) { return *this; }
+};
+
+}
+
+#endif
+
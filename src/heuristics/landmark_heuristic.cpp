@@ -0,0 +1,346 @@
+#include "gridmap.h"
+#include "landmark_heuristic.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace
+{
+
+const uint32_t NONE = 0xffffffff;
+
+// moves, in order: N, S, E, W, NE, NW, SE, SW
+const int32_t DX[8] = { 0, 0, 1, -1,  1, -1, 1, -1};
+const int32_t DY[8] = {-1, 1, 0,  0, -1, -1, 1,  1};
+
+// the moves that can be made from each tile of a map (bit i = move i);
+// diagonal moves may not cut corners
+std::vector<uint8_t>
+legal_moves(warthog::gridmap* map)
+{
+	uint32_t width = map->width();
+	std::vector<uint8_t> moves(map->padded_mapsize(), 0);
+	for(uint32_t id = width; id < map->padded_mapsize() - width; id++)
+	{
+		if(!map->get_label(id)) { continue; }
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			if(map->get_label(id + DY[m]*(int32_t)width + DX[m]) &&
+				map->get_label(id + DX[m]) &&
+				map->get_label(id + DY[m]*(int32_t)width))
+			{
+				moves[id] |= (1 << m);
+			}
+		}
+	}
+	return moves;
+}
+
+// breadth-first search from @param source: the number of moves to every
+// tile (NONE if unreachable), the parent of every tile and the order in
+// which tiles were reached
+void
+bfs(std::vector<uint8_t>& moves, uint32_t width, uint32_t source,
+		std::vector<uint32_t>& hops, std::vector<uint32_t>& parent,
+		std::vector<uint32_t>& order)
+{
+	hops.assign(moves.size(), NONE);
+	parent.assign(moves.size(), NONE);
+	order.clear();
+	hops[source] = 0;
+	order.push_back(source);
+	for(uint32_t i = 0; i < order.size(); i++)
+	{
+		uint32_t id = order[i];
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			uint32_t nid = id + DY[m]*(int32_t)width + DX[m];
+			if((moves[id] & (1 << m)) && hops[nid] == NONE)
+			{
+				hops[nid] = hops[id] + 1;
+				parent[nid] = id;
+				order.push_back(nid);
+			}
+		}
+	}
+}
+
+// exact distances from @param source to every tile (warthog::COST_MAX if
+// unreachable)
+void
+dijkstra(std::vector<uint8_t>& moves, uint32_t width, uint32_t source,
+		std::vector<warthog::cost_t>& dist)
+{
+	typedef std::pair<warthog::cost_t, uint32_t> entry;
+	std::greater<entry> cmp;
+	std::vector<entry> heap;
+	dist.assign(moves.size(), warthog::COST_MAX);
+	dist[source] = 0;
+	heap.push_back(entry(0, source));
+	while(heap.size())
+	{
+		std::pop_heap(heap.begin(), heap.end(), cmp);
+		entry e = heap.back();
+		heap.pop_back();
+		uint32_t id = e.second;
+		if(e.first > dist[id]) { continue; }
+
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			if(!(moves[id] & (1 << m))) { continue; }
+			uint32_t nid = id + DY[m]*(int32_t)width + DX[m];
+			warthog::cost_t g = e.first +
+				(m < 4 ? warthog::ONE : warthog::ROOT_TWO);
+			if(g < dist[nid])
+			{
+				dist[nid] = g;
+				heap.push_back(entry(g, nid));
+				std::push_heap(heap.begin(), heap.end(), cmp);
+			}
+		}
+	}
+}
+
+}
+
+warthog::landmark_heuristic::landmark_heuristic(warthog::gridmap* map,
+		uint32_t num_landmarks, uint32_t strategy, uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn progress)
+	: map_(map), octile_(map->width(), map->height()),
+	num_landmarks_(num_landmarks), strategy_(strategy), quantum_(1),
+	preproc_time_(0),
+	file_(map, ".alt", warthog::mapped_db_ns::LANDMARKS,
+		warthog::landmark_ns::VERSION, "landmark database"),
+	dist_(0)
+{
+	if(num_landmarks_ == 0) { num_landmarks_ = 1; }
+	stride_ = (num_landmarks_ + warthog::landmark_ns::GROUP - 1) /
+		warthog::landmark_ns::GROUP * warthog::landmark_ns::GROUP;
+	if(load()) { return; }
+
+	if(nthreads == 0) { nthreads = warthog::jpsplus_preproc::default_threads(); }
+	warthog::timer mytimer;
+	mytimer.start();
+	std::vector<uint8_t> moves = legal_moves(map_);
+	select(moves);
+	compute(moves, nthreads, progress);
+	mytimer.stop();
+	preproc_time_ = mytimer.elapsed_time_micro();
+	std::cerr << "landmarks computed in " << preproc_time_ / 1e6
+		<< "s using " << nthreads << " thread(s); " << num_landmarks_
+		<< " landmarks, quantum " << quantum_ << "\n";
+
+	save();
+}
+
+warthog::landmark_heuristic::~landmark_heuristic()
+{
+}
+
+bool
+warthog::landmark_heuristic::load()
+{
+	// the header holds the number of landmarks, the selection strategy
+	// and the quantum; the quantum is not known in advance
+	uint64_t num_landmarks = num_landmarks_;
+	uint64_t strategy = strategy_;
+	uint64_t dbsize = sizeof(uint32_t) * num_landmarks_ +
+		sizeof(uint16_t) * stride_ * (uint64_t)map_->padded_mapsize();
+	if(!file_.load([=](const uint64_t* params) {
+				return (params[0] == num_landmarks &&
+					params[1] == strategy && params[2] != 0) ?
+					dbsize : warthog::mapped_db_ns::UNSUITABLE; }))
+	{
+		return false;
+	}
+
+	quantum_ = file_.params()[2];
+	const uint32_t* ids = (const uint32_t*)file_.payload();
+	landmarks_.assign(ids, ids + num_landmarks_);
+	dist_ = (const uint16_t*)(ids + num_landmarks_);
+	return true;
+}
+
+bool
+warthog::landmark_heuristic::save()
+{
+	uint64_t params[warthog::mapped_db_ns::NUM_PARAMS] =
+		{ num_landmarks_, strategy_, quantum_ };
+	warthog::mapped_db_ns::block blocks[2] = {
+		{ &landmarks_[0], sizeof(uint32_t) * num_landmarks_ },
+		{ dist_, sizeof(uint16_t) * stride_ * (size_t)map_->padded_mapsize() } };
+	return file_.save(params, blocks, 2);
+}
+
+void
+warthog::landmark_heuristic::select(std::vector<uint8_t>& moves)
+{
+	uint32_t width = map_->width();
+	uint32_t mapsize = moves.size();
+	std::vector<uint32_t> tiles;
+	for(uint32_t id = 0; id < mapsize; id++)
+	{
+		if(map_->get_label(id)) { tiles.push_back(id); }
+	}
+	if(tiles.size() == 0)
+	{
+		landmarks_.assign(num_landmarks_, 0);
+		return;
+	}
+
+	// hops from each landmark, and from the nearest one (to begin with,
+	// from an arbitrary tile)
+	std::vector< std::vector<uint32_t> > lm_hops;
+	std::vector<uint32_t> hops, parent, order;
+	bfs(moves, width, tiles[0], hops, parent, order);
+	std::vector<uint32_t> nearest = hops;
+	std::minstd_rand rng(map_->checksum());
+	landmarks_.clear();
+	while(landmarks_.size() < num_landmarks_)
+	{
+		uint32_t lm = NONE;
+		if(strategy_ == warthog::landmark_ns::AVOID && landmarks_.size())
+		{
+			uint32_t root = tiles[rng() % tiles.size()];
+			bfs(moves, width, root, hops, parent, order);
+
+			// weigh every tile by the error of the current heuristic and
+			// sum the weights of each subtree (0 if there is a landmark in
+			// it); children are reached after their parents
+			std::vector<uint64_t> size(mapsize, 0);
+			std::vector<uint8_t> covered(mapsize, 0);
+			std::vector<uint32_t> heaviest(mapsize, NONE);
+			for(uint32_t i = 0; i < landmarks_.size(); i++)
+			{
+				covered[landmarks_[i]] = 1;
+			}
+			for(uint32_t i = order.size(); i-- > 0; )
+			{
+				uint32_t id = order[i];
+				uint32_t bound = 0;
+				for(uint32_t j = 0; j < lm_hops.size(); j++)
+				{
+					uint32_t a = lm_hops[j][root], b = lm_hops[j][id];
+					uint32_t d = a > b ? a - b : b - a;
+					bound = d > bound ? d : bound;
+				}
+				size[id] += hops[id] - bound;
+				if(covered[id]) { size[id] = 0; }
+				if(id == root) { break; }
+
+				uint32_t p = parent[id];
+				covered[p] |= covered[id];
+				size[p] += size[id];
+				if(!covered[id] && (heaviest[p] == NONE ||
+							size[id] > size[heaviest[p]]))
+				{
+					heaviest[p] = id;
+				}
+			}
+			for(uint32_t id = root; heaviest[id] != NONE; id = heaviest[id])
+			{
+				lm = heaviest[id];
+			}
+		}
+		if(lm == NONE)
+		{
+			// the (reachable) tile farthest from every landmark
+			lm = tiles[0];
+			for(uint32_t i = 0; i < tiles.size(); i++)
+			{
+				uint32_t d = nearest[tiles[i]];
+				if(d != NONE && (nearest[lm] == NONE || d > nearest[lm]))
+				{
+					lm = tiles[i];
+				}
+			}
+		}
+
+		bool first = landmarks_.size() == 0;
+		landmarks_.push_back(lm);
+		bfs(moves, width, lm, hops, parent, order);
+		lm_hops.push_back(hops);
+		for(uint32_t i = 0; i < tiles.size(); i++)
+		{
+			uint32_t id = tiles[i];
+			nearest[id] = first ? hops[id] : std::min(nearest[id], hops[id]);
+		}
+	}
+}
+
+void
+warthog::landmark_heuristic::compute(std::vector<uint8_t>& moves,
+		uint32_t nthreads, warthog::jpsplus_preproc::progress_fn& progress)
+{
+	uint32_t width = map_->width();
+	std::vector< std::vector<warthog::cost_t> > exact(num_landmarks_);
+	std::atomic<uint32_t> next(0);
+	std::atomic<uint32_t> done(0);
+	std::thread::id owner = std::this_thread::get_id();
+	std::function<void()> work = [&]() {
+		for(uint32_t l = next.fetch_add(1); l < num_landmarks_;
+				l = next.fetch_add(1))
+		{
+			dijkstra(moves, width, landmarks_[l], exact[l]);
+			uint32_t finished = done.fetch_add(1) + 1;
+			if(progress && std::this_thread::get_id() == owner)
+			{
+				progress(finished, num_landmarks_);
+			}
+		}
+	};
+
+	std::vector<std::thread*> threads;
+	for(uint32_t i = 1; i < nthreads && i < num_landmarks_; i++)
+	{
+		threads.push_back(new std::thread(work));
+	}
+	work();
+	for(uint32_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->join();
+		delete threads[i];
+	}
+	if(progress) { progress(num_landmarks_, num_landmarks_); }
+
+	// the smallest quantum that fits every (finite) distance in 16 bits,
+	// leaving the largest value for unreachable tiles
+	uint64_t max_dist = 0;
+	for(uint32_t l = 0; l < num_landmarks_; l++)
+	{
+		for(uint32_t id = 0; id < moves.size(); id++)
+		{
+			if(exact[l][id] != warthog::COST_MAX && exact[l][id] > max_dist)
+			{
+				max_dist = exact[l][id];
+			}
+		}
+	}
+	uint64_t max_value = warthog::landmark_ns::UNREACHABLE - 1;
+	quantum_ = std::max<uint64_t>(1, (max_dist + max_value - 1) / max_value);
+
+	heap_dist_.assign(stride_ * (size_t)moves.size(), 0);
+	for(uint32_t l = 0; l < num_landmarks_; l++)
+	{
+		for(uint32_t id = 0; id < moves.size(); id++)
+		{
+			heap_dist_[(size_t)id * stride_ + l] =
+				exact[l][id] == warthog::COST_MAX ?
+				warthog::landmark_ns::UNREACHABLE : exact[l][id] / quantum_;
+		}
+		std::vector<warthog::cost_t>().swap(exact[l]);
+	}
+	dist_ = &heap_dist_[0];
+}
+
+size_t
+warthog::landmark_heuristic::mem()
+{
+	return sizeof(*this) + sizeof(uint32_t) * landmarks_.capacity() +
+		sizeof(uint16_t) * stride_ * (size_t)map_->padded_mapsize();
+}
@@ -0,0 +1,201 @@
+#ifndef WARTHOG_LANDMARK_HEURISTIC_H
+#define WARTHOG_LANDMARK_HEURISTIC_H
+
+// landmark_heuristic.h
+//
+// A differential (ALT) heuristic for uniform-cost grid maps. A few tiles
+// are chosen as landmarks and the distance from every landmark to every
+// tile is computed in advance. By the triangle inequality, for any
+// landmark L, d(n, t) >= |d(L, n) - d(L, t)|. The heuristic is the largest
+// of these bounds and the octile distance; it is far better informed than
+// octile_heuristic alone on maps with many walls (mazes, rooms).
+//
+// Landmarks are selected with one of two strategies:
+//  - FARTHEST: each landmark is the tile farthest from those chosen so
+//    far (the first is the tile farthest from an arbitrary tile).
+//  - AVOID: the landmark is placed where the current landmarks give the
+//    worst bounds: grow a shortest path tree from a random root, weigh
+//    every tile by the error of the current heuristic, ignore subtrees
+//    which already contain a landmark and descend into the heaviest
+//    subtree down to a leaf.
+// Both strategies work on hop distances (computed by breadth-first
+// search) and are cheap. The exact distances are then computed with one
+// Dijkstra search per landmark, in parallel.
+//
+// Distances are stored in 16 bits: in units of q, where q is the smallest
+// quantum for which the longest distance fits. The bounds are scaled by
+// ONE / (ONE + q) so that the heuristic remains admissible and
+// consistent despite the rounding (flexible_astar never reopens nodes).
+// The distances to all landmarks of a tile are stored together and the
+// largest bound is found with SSE2 instructions, eight landmarks at a
+// time.
+//
+// The distances are stored next to the map (suffix .alt), in the format
+// of warthog::mapped_db, and mapped read-only into memory when they are
+// loaded. A file is used only if it matches the map, the number of
+// landmarks and the selection strategy.
+//
+// Ids are (padded) gridmap ids, as used by the expansion policies.
+//
+// Theoretical details:
+// [Goldberg A. and Harrelson C., 2005, Computing the Shortest Path: A*
+// Search Meets Graph Theory, SODA]
+// [Sturtevant N. et al., 2009, Memory-Based Heuristics for Explicit State
+// Spaces, IJCAI]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "constants.h"
+#include "gridmap.h"
+#include "jpsplus_preproc.h"
+#include "mapped_db.h"
+#include "octile_heuristic.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace warthog
+{
+
+namespace landmark_ns
+{
+	static const uint32_t VERSION = 1;
+
+	// landmark selection strategies
+	static const uint32_t FARTHEST = 1;
+	static const uint32_t AVOID = 2;
+
+	// landmarks are stored in groups of this size (one SSE2 register)
+	static const uint32_t GROUP = 8;
+
+	// the distance to a tile that a landmark cannot reach
+	static const uint16_t UNREACHABLE = 0xffff;
+}
+
+class landmark_heuristic
+{
+	public:
+		// the distances are loaded from disk or, if no valid copy exists,
+		// computed using @param nthreads threads (0 = one per core) and
+		// saved. @param strategy is one of the constants in landmark_ns.
+		landmark_heuristic(warthog::gridmap* map, uint32_t num_landmarks = 8,
+				uint32_t strategy = warthog::landmark_ns::AVOID,
+				uint32_t nthreads = 0,
+				warthog::jpsplus_preproc::progress_fn progress =
+				warthog::jpsplus_preproc::progress_fn());
+		~landmark_heuristic();
+
+		inline warthog::cost_t
+		h(warthog::sn_id_t id, warthog::sn_id_t id2)
+		{
+			warthog::cost_t octile = octile_.h(id, id2);
+			uint32_t diff = max_diff(dist_ + id * stride_, dist_ + id2 * stride_);
+			if(diff <= 1) { return octile; }
+
+			// see above; NB: diff-1 quanta are a lower bound on the
+			// difference between the exact distances
+			warthog::cost_t alt = (uint64_t)(diff - 1) * quantum_ *
+				warthog::ONE / (warthog::ONE + quantum_);
+			return alt > octile ? alt : octile;
+		}
+
+		inline uint32_t
+		num_landmarks() { return num_landmarks_; }
+
+		// the (padded) id of every landmark
+		inline const std::vector<uint32_t>&
+		get_landmarks() { return landmarks_; }
+
+		// cost units per unit of stored distance
+		inline uint64_t
+		get_quantum() { return quantum_; }
+
+		// time (in microseconds) spent computing the distances;
+		// zero if they were loaded from disk
+		inline double
+		get_preproc_time() { return preproc_time_; }
+
+		size_t
+		mem();
+
+	private:
+		warthog::gridmap* map_;
+		warthog::octile_heuristic octile_;
+		uint32_t num_landmarks_;
+		uint32_t stride_; // num_landmarks_, rounded up to a full GROUP
+		uint32_t strategy_;
+		uint64_t quantum_;
+		double preproc_time_;
+		std::vector<uint32_t> landmarks_;
+
+		// stride_ distances per tile, in a mapped file or in heap_dist_
+		warthog::mapped_db file_;
+		const uint16_t* dist_;
+		std::vector<uint16_t> heap_dist_;
+
+		// @return the largest difference between the distances @param a
+		// and @param b (stride_ of each)
+		inline uint32_t
+		max_diff(const uint16_t* a, const uint16_t* b)
+		{
+#ifdef __SSE2__
+			__m128i best = _mm_setzero_si128();
+			for(uint32_t i = 0; i < stride_; i += warthog::landmark_ns::GROUP)
+			{
+				__m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+				__m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+				__m128i d = _mm_or_si128(
+						_mm_subs_epu16(x, y), _mm_subs_epu16(y, x));
+				// unsigned max(best, d) = (best -sat d) + d
+				best = _mm_add_epi16(_mm_subs_epu16(best, d), d);
+			}
+			__m128i s = _mm_srli_si128(best, 8);
+			best = _mm_add_epi16(_mm_subs_epu16(best, s), s);
+			s = _mm_srli_si128(best, 4);
+			best = _mm_add_epi16(_mm_subs_epu16(best, s), s);
+			s = _mm_srli_si128(best, 2);
+			best = _mm_add_epi16(_mm_subs_epu16(best, s), s);
+			return (uint16_t)_mm_cvtsi128_si32(best);
+#else
+			uint32_t best = 0;
+			for(uint32_t i = 0; i < stride_; i++)
+			{
+				uint32_t d = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+				best = d > best ? d : best;
+			}
+			return best;
+#endif
+		}
+
+		bool
+		load();
+
+		bool
+		save();
+
+		// choose landmarks_ as per strategy_
+		void
+		select(std::vector<uint8_t>& moves);
+
+		// fill heap_dist_ and set quantum_
+		void
+		compute(std::vector<uint8_t>& moves, uint32_t nthreads,
+				warthog::jpsplus_preproc::progress_fn& progress);
+
+		// no copy
+		landmark_heuristic(const landmark_heuristic& other)
+			: octile_(0, 0), file_(0, "", 0, 0, "") { }
+		landmark_heuristic&
+		operator=(const landmark_heuristic& other) { return *this; }
+};
+
+}
+
+#endif
@@ -29,8 +29,8 @@ class octile_heuristic
 				unsigned int x2, unsigned int y2)
 		{
             // NB: precision loss when warthog::cost_t is an integer
-			double dx = abs(x-x2);
-			double dy = abs(y-y2);
+			double dx = abs((int)(x-x2));
+			double dy = abs((int)(y-y2));
 			if(dx < dy)
 			{
 				return dx * warthog::ROOT_TWO + (dy - dx) * warthog::ONE;
@@ -53,6 +53,30 @@ class octile_heuristic
 		unsigned int mapheight_;
 };
 
+// as octile_heuristic, for maps whose ids are not row-major (such as
+// warthog::blockmap); ids are converted to coordinates by the map
+template <class M>
+class map_octile_heuristic
+{
+	public:
+		map_octile_heuristic(M* map) : map_(map), octile_(0, 0) { }
+		~map_octile_heuristic() { }
+
+		inline warthog::cost_t
+		h(unsigned int id, unsigned int id2)
+		{
+			uint32_t x, x2;
+			uint32_t y, y2;
+			map_->to_padded_xy(id, x, y);
+			map_->to_padded_xy(id2, x2, y2);
+			return octile_.h(x, y, x2, y2);
+		}
+
+	private:
+		M* map_;
+		warthog::octile_heuristic octile_;
+};
+
 }
 
 #endif
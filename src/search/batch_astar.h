@@ -0,0 +1,278 @@
+#ifndef WARTHOG_BATCH_ASTAR_H
+#define WARTHOG_BATCH_ASTAR_H
+
+// batch_astar.h
+//
+// Answers batches of point-to-point queries using a pool of worker
+// threads. Each worker owns a flexible_astar instance together with an
+// expansion policy (and hence its own open list and node pool).
+// The expansion policies are created by the caller and may share a single
+// read-only map and jump point locator; the heuristic is shared by all
+// workers and must not have mutable state.
+//
+// Workers are created once and persist across batches. Queries are
+// handed out dynamically: each worker claims the next unsolved query
+// from a shared counter and writes its answer to a dedicated result slot.
+// No other synchronisation happens during search.
+//
+// Search limits (see flexible_astar.h) apply to each query separately. 
+// A query that exceeds them is abandoned and its worker moves on to the 
+// next one; cancelling a shared warthog::cancel_token abandons every 
+// unfinished query in the batch.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "flexible_astar.h"
+#include "timer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace warthog
+{
+
+// the answer to a single query in a batch. paths are sequences of
+// (padded) node ids, from start to goal. an empty path indicates the 
+// goal is not reachable (or the query was aborted; see status).
+struct batch_result
+{
+	warthog::search_status status;
+	double length;
+	std::vector<warthog::sn_id_t> path;
+	uint32_t nodes_expanded;
+	uint32_t nodes_generated;
+	uint32_t nodes_touched;
+	double search_time;
+};
+
+// H is a heuristic function
+// E is an expansion policy
+// Q is the open list
+template <class H, class E, class Q = warthog::default_open_list>
+class batch_astar
+{
+	public:
+		// one worker thread is created for each expansion policy
+		batch_astar(H* heuristic, std::vector<E*>& expanders)
+			: queries_(0), results_(0), want_paths_(false), next_(0),
+			running_(0), generation_(0), shutdown_(false), batch_time_(0)
+		{
+			for(uint32_t i = 0; i < expanders.size(); i++)
+			{
+				searches_.push_back(
+					new warthog::flexible_astar<H, E, Q>(heuristic, expanders[i]));
+			}
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				threads_.push_back(new std::thread(
+						&batch_astar<H, E, Q>::worker_main, this, i));
+			}
+		}
+
+		~batch_astar()
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				shutdown_ = true;
+			}
+			start_cv_.notify_all();
+
+			for(uint32_t i = 0; i < threads_.size(); i++)
+			{
+				threads_[i]->join();
+				delete threads_[i];
+			}
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				delete searches_[i];
+			}
+		}
+
+		// solve every (start, goal) pair in @param queries.
+		// the answer to queries[i] is written to results[i].
+		// this function blocks until the entire batch is finished.
+		void
+		run(std::vector< std::pair<warthog::sn_id_t, warthog::sn_id_t> >& queries,
+			std::vector<warthog::batch_result>& results, bool want_paths)
+		{
+			results.resize(queries.size());
+
+			warthog::timer mytimer;
+			mytimer.start();
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			queries_ = &queries;
+			results_ = &results;
+			want_paths_ = want_paths;
+			next_ = 0;
+			running_ = threads_.size();
+			generation_++;
+			start_cv_.notify_all();
+
+			while(running_ != 0)
+			{
+				done_cv_.wait(lock);
+			}
+			queries_ = 0;
+			results_ = 0;
+
+			mytimer.stop();
+			batch_time_ = mytimer.elapsed_time_micro();
+		}
+
+		inline uint32_t
+		num_threads() { return threads_.size(); }
+
+		// wallclock time (in microseconds) required to solve the last batch
+		inline double
+		get_batch_time() { return batch_time_; }
+
+		inline void
+		set_hscale(double hscale)
+		{
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				searches_[i]->set_hscale(hscale);
+			}
+		}
+
+		inline void
+		set_node_budget(uint32_t max_expansions)
+		{
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				searches_[i]->set_node_budget(max_expansions);
+			}
+		}
+
+		inline void
+		set_time_limit(double max_micros)
+		{
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				searches_[i]->set_time_limit(max_micros);
+			}
+		}
+
+		inline void
+		set_cancel_token(warthog::cancel_token* token)
+		{
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				searches_[i]->set_cancel_token(token);
+			}
+		}
+
+		inline void
+		set_component_index(warthog::component_index* components)
+		{
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				searches_[i]->set_component_index(components);
+			}
+		}
+
+		inline size_t
+		mem()
+		{
+			size_t bytes = sizeof(*this);
+			for(uint32_t i = 0; i < searches_.size(); i++)
+			{
+				bytes += searches_[i]->mem();
+			}
+			return bytes;
+		}
+
+	private:
+		std::vector<warthog::flexible_astar<H, E, Q>*> searches_;
+		std::vector<std::thread*> threads_;
+
+		// the current batch
+		std::vector< std::pair<warthog::sn_id_t, warthog::sn_id_t> >* queries_;
+		std::vector<warthog::batch_result>* results_;
+		bool want_paths_;
+		std::atomic<uint32_t> next_;
+
+		// worker coordination
+		std::mutex mutex_;
+		std::condition_variable start_cv_;
+		std::condition_variable done_cv_;
+		uint32_t running_;
+		uint32_t generation_;
+		bool shutdown_;
+
+		double batch_time_;
+
+		// no copy
+		batch_astar(const batch_astar& other) { }
+		batch_astar&
+		operator=(const batch_astar& other) { return *this; }
+
+		void
+		worker_main(uint32_t index)
+		{
+			warthog::flexible_astar<H, E, Q>* astar = searches_[index];
+			uint32_t seen = 0;
+			while(true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					while(!shutdown_ && generation_ == seen)
+					{
+						start_cv_.wait(lock);
+					}
+					if(shutdown_) { return; }
+					seen = generation_;
+				}
+
+				uint32_t num_queries = queries_->size();
+				for(uint32_t qi = next_.fetch_add(1); qi < num_queries;
+						qi = next_.fetch_add(1))
+				{
+					solve(astar, qi);
+				}
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					if(--running_ == 0)
+					{
+						done_cv_.notify_all();
+					}
+				}
+			}
+		}
+
+		inline void
+		solve(warthog::flexible_astar<H, E, Q>* astar, uint32_t qi)
+		{
+			warthog::sn_id_t startid = (*queries_)[qi].first;
+			warthog::sn_id_t goalid = (*queries_)[qi].second;
+			warthog::batch_result& result = (*results_)[qi];
+
+			if(want_paths_)
+			{
+				result.length = astar->get_path(startid, goalid, result.path);
+			}
+			else
+			{
+				result.path.clear();
+				result.length = astar->get_length(startid, goalid);
+			}
+			result.status = astar->get_status();
+			result.nodes_expanded = astar->get_nodes_expanded();
+			result.nodes_generated = astar->get_nodes_generated();
+			result.nodes_touched = astar->get_nodes_touched();
+			result.search_time = astar->get_search_time();
+		}
+};
+
+}
+
+#endif
+
@@ -0,0 +1,397 @@
+#ifndef WARTHOG_BIDIRECTIONAL_ASTAR_H
+#define WARTHOG_BIDIRECTIONAL_ASTAR_H
+
+// bidirectional_astar.h
+//
+// Bidirectional (front-to-end) A*. One frontier grows forward from the
+// start and the other backward from the goal. Each direction has its own
+// open list and its own expansion policy (hence its own node pool); the
+// forward heuristic estimates the distance to the goal and the backward
+// heuristic the distance to the start.
+//
+// Both open lists are ordered by g plus a potential derived from the 
+// heuristic h [Ikeda et al. 1994]: the forward potential of a node n is 
+// pf(n) = (h(n, goal) - h(n, start) + h(start, goal)) / 2 and the backward
+// potential is pb(n) = h(start, goal) - pf(n). The two searches then agree 
+// on the (non-negative) reduced cost of every edge, and the search stops 
+// as in bidirectional Dijkstra: once the smallest keys of the two open 
+// lists add up to no less than mu + h(start, goal), where mu is the cost 
+// of the best path found so far. Candidate paths are recorded whenever a 
+// node is labelled (or relabelled) in one direction after it has been 
+// reached by the other. Nodes n with g(n) + h(n, target) >= mu are never 
+// added to an open list. The heuristic must be consistent and satisfy the
+// triangle inequality (e.g. octile distance).
+//
+// Each iteration advances the direction with fewer open nodes.
+//
+// The backward search uses the same successor function as the forward
+// search. This is correct on graphs where every edge can be traversed in
+// either direction at the same cost, such as those generated by
+// warthog::gridmap_expansion_policy and warthog::wgridmap_expansion_policy.
+// In addition to the interface required by warthog::flexible_astar,
+// policies must implement ::find (look up a node without generating it).
+//
+// Given a warthog::component_index (::set_component_index), queries 
+// between different connected components are rejected without search.
+//
+// Theoretical details:
+// [Pohl I., 1971, Bi-directional Search, Machine Intelligence 6]
+// [Ikeda T. et al., 1994, A Fast Algorithm for Finding Better Routes by
+// AI Search Techniques, Vehicle Navigation and Information Systems]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "component_index.h"
+#include "flexible_astar.h"
+#include "problem_instance.h"
+#include "search_node.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace warthog
+{
+
+// H is a heuristic function
+// E is an expansion policy
+// Q is the open list
+template <class H, class E, class Q = warthog::default_open_list>
+class bidirectional_astar
+{
+	public:
+		// @param fexpander and @param bexpander generate the nodes of the
+		// forward and backward search respectively; they must be distinct
+		bidirectional_astar(H* heuristic, E* fexpander, E* bexpander)
+			: heuristic_(heuristic), verbose_(false), searchid_(0),
+			hscale_(1.0), components_(0)
+		{
+			expander_[FORWARD] = fexpander;
+			expander_[BACKWARD] = bexpander;
+			open_[FORWARD] = new Q(1024, true);
+			open_[BACKWARD] = new Q(1024, true);
+		}
+
+		~bidirectional_astar()
+		{
+			cleanup();
+			delete open_[FORWARD];
+			delete open_[BACKWARD];
+		}
+
+		// the path is written to @param path (which is cleared first) as
+		// a sequence of (padded) ids, from start to goal.
+		// @return the length of the path
+		double
+		get_path(warthog::sn_id_t startid, warthog::sn_id_t goalid,
+				std::vector<warthog::sn_id_t>& path)
+		{
+			path.clear();
+			warthog::cost_t len = search(startid, goalid);
+			if(len != warthog::COST_MAX)
+			{
+				// the meeting node and its forward ancestors, reversed
+				for(warthog::search_node* cur =
+						expander_[FORWARD]->find(meet_id_);
+						cur != 0;
+						cur = parent_of(FORWARD, cur))
+				{
+					path.push_back(cur->get_id());
+				}
+				std::reverse(path.begin(), path.end());
+
+				// followed by its backward ancestors
+				warthog::search_node* cur =
+					expander_[BACKWARD]->find(meet_id_);
+				for(cur = parent_of(BACKWARD, cur);
+						cur != 0;
+						cur = parent_of(BACKWARD, cur))
+				{
+					path.push_back(cur->get_id());
+				}
+				assert(path.front() == startid && path.back() == goalid);
+			}
+			cleanup();
+			return len / (double)warthog::ONE;
+		}
+
+		double
+		get_length(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			warthog::cost_t len = search(startid, goalid);
+			cleanup();
+			return len / (double)warthog::ONE;
+		}
+
+		inline size_t
+		mem()
+		{
+			return sizeof(*this) +
+				open_[FORWARD]->mem() + open_[BACKWARD]->mem() +
+				expander_[FORWARD]->mem() + expander_[BACKWARD]->mem();
+		}
+
+		// totals for both directions
+		inline uint32_t
+		get_nodes_expanded() { return nodes_expanded_; }
+
+		inline uint32_t
+		get_nodes_generated() { return nodes_generated_; }
+
+		inline uint32_t
+		get_nodes_touched() { return nodes_touched_; }
+
+		inline double
+		get_search_time() { return search_time_; }
+
+		inline bool
+		get_verbose() { return verbose_; }
+
+		inline void
+		set_verbose(bool verbose) { verbose_ = verbose; }
+
+		inline double
+		get_hscale() { return hscale_; }
+
+		inline void
+		set_hscale(double hscale) { hscale_ = hscale; }
+
+		inline void
+		set_component_index(warthog::component_index* components)
+		{
+			components_ = components;
+		}
+
+	private:
+		static const uint32_t FORWARD = 0;
+		static const uint32_t BACKWARD = 1;
+
+		H* heuristic_;
+		E* expander_[2];
+		Q* open_[2];
+		bool verbose_;
+		uint32_t searchid_;
+		uint32_t nodes_expanded_;
+		uint32_t nodes_generated_;
+		uint32_t nodes_touched_;
+		double search_time_;
+		double hscale_;
+		warthog::component_index* components_;
+
+		// the best path found so far (mu) and the node where the forward
+		// and backward halves of that path meet
+		warthog::cost_t best_;
+		warthog::sn_id_t meet_id_;
+
+		// h(start, goal). keys are offset by this amount so they are never
+		// negative (i.e. key = g + potential + hsg_)
+		warthog::cost_t hsg_;
+
+		// no copy
+		bidirectional_astar(const bidirectional_astar& other) { }
+		bidirectional_astar&
+		operator=(const bidirectional_astar& other) { return *this; }
+
+		// @return the cost of an optimal path from @param startid to
+		// @param goalid or warthog::COST_MAX if there is no path
+		warthog::cost_t
+		search(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			nodes_expanded_ = nodes_generated_ = nodes_touched_ = 0;
+			search_time_ = 0;
+
+			warthog::timer mytimer;
+			mytimer.start();
+			if(components_ && !components_->reachable(startid, goalid))
+			{
+				mytimer.stop();
+				search_time_ = mytimer.elapsed_time_micro();
+				return warthog::COST_MAX;
+			}
+
+			// NB: searchid 0 is reserved for freshly allocated nodes
+			searchid_++;
+			warthog::problem_instance instance[2];
+			instance[FORWARD].set_start(startid);
+			instance[FORWARD].set_goal(goalid);
+			instance[BACKWARD].set_start(goalid);
+			instance[BACKWARD].set_goal(startid);
+
+			best_ = warthog::COST_MAX;
+			meet_id_ = warthog::INF;
+			hsg_ = h(startid, goalid);
+			for(uint32_t d = FORWARD; d <= BACKWARD; d++)
+			{
+				instance[d].set_searchid(searchid_);
+				warthog::sn_id_t root_id = instance[d].get_start();
+				warthog::search_node* root = expander_[d]->generate(root_id);
+				root->reset(searchid_);
+				root->set_g(0);
+				push(d, root, key(d, 0, h(root_id, goalid), h(root_id, startid)));
+			}
+			if(startid == goalid)
+			{
+				best_ = 0;
+				meet_id_ = startid;
+			}
+
+			while(open_[FORWARD]->size() && open_[BACKWARD]->size())
+			{
+				nodes_touched_++;
+				if(best_ != warthog::COST_MAX &&
+						min_key(FORWARD) + min_key(BACKWARD) >= best_ + 3*hsg_)
+				{
+					break;
+				}
+
+				uint32_t d = open_[BACKWARD]->size() < open_[FORWARD]->size()
+					? BACKWARD : FORWARD;
+				warthog::search_node* current = open_[d]->pop();
+				current->set_expanded(true);
+				nodes_expanded_++;
+				#ifndef NDEBUG
+				if(verbose_)
+				{
+					std::cerr << (d == FORWARD ? "forward " : "backward ")
+						<< "expanding ";
+					current->print(std::cerr);
+					std::cerr << std::endl;
+				}
+				#endif
+				expand(d, current, startid, goalid);
+			}
+
+			mytimer.stop();
+			search_time_ = mytimer.elapsed_time_micro();
+			return best_;
+		}
+
+		// relax the successors of @param current in direction @param d
+		inline void
+		expand(uint32_t d, warthog::search_node* current,
+				warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			warthog::problem_instance instance;
+			instance.set_start(d == FORWARD ? startid : goalid);
+			instance.set_goal(d == FORWARD ? goalid : startid);
+			instance.set_searchid(searchid_);
+			E* expander = expander_[d];
+			expander->expand(current, &instance);
+
+			warthog::search_node* n = 0;
+			warthog::cost_t cost_to_n = warthog::COST_MAX;
+			for(expander->first(n, cost_to_n);
+					n != 0;
+					expander->next(n, cost_to_n))
+			{
+				nodes_touched_++;
+				if(n->get_expanded()) { continue; }
+
+				warthog::cost_t gval = current->get_g() + cost_to_n;
+				if(open_[d]->contains(n))
+				{
+					if(gval >= n->get_g()) { continue; }
+					n->relax(gval, current);
+					open_[d]->decrease_key(n);
+				}
+				else
+				{
+					// nodes with f >= mu cannot improve on the best path
+					warthog::cost_t h_goal = h(n->get_id(), goalid);
+					warthog::cost_t h_start = h(n->get_id(), startid);
+					if(gval + (d == FORWARD ? h_goal : h_start) >= best_)
+					{
+						continue;
+					}
+					n->set_g(gval);
+					n->set_parent(current);
+					push(d, n, key(d, gval, h_goal, h_start));
+					nodes_generated_++;
+				}
+
+				// a path through n, if the opposite search has reached n
+				warthog::search_node* other =
+					expander_[1-d]->find(n->get_id());
+				if(other && other->get_g() != warthog::COST_MAX &&
+						(gval + other->get_g()) < best_)
+				{
+					best_ = gval + other->get_g();
+					meet_id_ = n->get_id();
+				}
+			}
+		}
+
+		// add @param n to the open list of direction @param d with
+		// priority @param fval
+		inline void
+		push(uint32_t d, warthog::search_node* n, warthog::cost_t fval)
+		{
+#ifdef WARTHOG_COMPACT_NODES
+			open_[d]->push(n, fval);
+#else
+			n->set_f(fval);
+			open_[d]->push(n);
+#endif
+		}
+
+		inline warthog::cost_t
+		h(warthog::sn_id_t from, warthog::sn_id_t to)
+		{
+			return heuristic_->h(from, to) * hscale_;
+		}
+
+		// @return g + potential + hsg_ for a node with g-value @param g and 
+		// heuristic values @param h_goal and @param h_start. 
+		// NB: pf is rounded down and pb = h(start, goal) - pf, so both 
+		// searches see the same reduced edge costs; these are integers 
+		// greater than -1, hence non-negative.
+		inline warthog::cost_t
+		key(uint32_t d, warthog::cost_t g, warthog::cost_t h_goal,
+				warthog::cost_t h_start)
+		{
+			// 2*pf + 2*hsg_, which is positive by the triangle inequality
+			warthog::cost_t pf2 = h_goal + 3*hsg_ - h_start;
+			if(d == FORWARD) { return g + (pf2 >> 1); }
+			return g + 3*hsg_ - (pf2 >> 1);
+		}
+
+		// @return the smallest key on the open list of direction @param d
+		inline warthog::cost_t
+		min_key(uint32_t d)
+		{
+#ifdef WARTHOG_COMPACT_NODES
+			return open_[d]->peek_f();
+#else
+			return open_[d]->peek()->get_f();
+#endif
+		}
+
+		inline warthog::search_node*
+		parent_of(uint32_t d, warthog::search_node* n)
+		{
+#ifdef WARTHOG_COMPACT_NODES
+			warthog::sn_id_t parent_id = n->get_parent_id();
+			if(parent_id == warthog::INF) { return 0; }
+			return expander_[d]->generate(parent_id);
+#else
+			return n->get_parent();
+#endif
+		}
+
+		void
+		cleanup()
+		{
+			for(uint32_t d = FORWARD; d <= BACKWARD; d++)
+			{
+				open_[d]->clear();
+				expander_[d]->clear();
+			}
+		}
+};
+
+}
+
+#endif
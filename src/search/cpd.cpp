@@ -0,0 +1,255 @@
+#include "cpd.h"
+#include "first_move_search.h"
+#include "gridmap.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+// the size (in bytes) of a database with @param num_nodes tables and
+// @param num_runs runs, for a map of @param mapsize (padded) tiles
+uint64_t
+db_size(uint64_t num_nodes, uint64_t num_runs, uint64_t mapsize)
+{
+	return sizeof(uint64_t) * (num_nodes + 1) +
+		sizeof(uint32_t) * mapsize +
+		sizeof(uint32_t) * num_nodes +
+		sizeof(warthog::rle::run) * num_runs;
+}
+
+}
+
+const uint32_t warthog::cpd::NONE;
+
+warthog::cpd::cpd(warthog::gridmap* map, uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn progress)
+	: map_(map), width_(map->width()), num_nodes_(0), num_runs_(0),
+	preproc_time_(0),
+	file_(map, ".cpd", warthog::mapped_db_ns::CPD, warthog::cpd_ns::VERSION,
+		"path database"),
+	offsets_(0), rank_(0), comp_(0), runs_(0)
+{
+	if(load()) { return; }
+
+	if(nthreads == 0) { nthreads = warthog::jpsplus_preproc::default_threads(); }
+	warthog::timer mytimer;
+	mytimer.start();
+	compute(nthreads, progress);
+	mytimer.stop();
+	preproc_time_ = mytimer.elapsed_time_micro();
+	std::cerr << "path database computed in "
+		<< preproc_time_ / 1e6 << "s using " << nthreads << " thread(s); "
+		<< num_nodes_ << " nodes, " << num_runs_ << " runs\n";
+
+	save();
+}
+
+warthog::cpd::~cpd()
+{
+}
+
+bool
+warthog::cpd::load()
+{
+	// the header holds the number of tables and runs
+	uint64_t mapsize = map_->padded_mapsize();
+	if(!file_.load([mapsize](const uint64_t* params) {
+				return params[0] > warthog::rle::MAX_INDEX ?
+					warthog::mapped_db_ns::UNSUITABLE :
+					db_size(params[0], params[1], mapsize); }))
+	{
+		return false;
+	}
+
+	num_nodes_ = file_.params()[0];
+	num_runs_ = file_.params()[1];
+	offsets_ = (const uint64_t*)file_.payload();
+	rank_ = (const uint32_t*)(offsets_ + num_nodes_ + 1);
+	comp_ = rank_ + map_->padded_mapsize();
+	runs_ = comp_ + num_nodes_;
+	return true;
+}
+
+void
+warthog::cpd::compute(uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn& progress)
+{
+	std::vector<uint8_t> moves = warthog::first_move_ns::legal_moves(map_);
+
+	// number the tiles in depth-first order, one component at a time
+	uint32_t mapsize = map_->padded_mapsize();
+	heap_rank_.assign(mapsize, NONE);
+	heap_comp_.clear();
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> stack;
+	uint32_t num_comps = 0;
+	for(uint32_t root = 0; root < mapsize; root++)
+	{
+		if(!map_->get_label(root) || heap_rank_[root] != NONE) { continue; }
+		stack.push_back(root);
+		while(stack.size())
+		{
+			uint32_t id = stack.back();
+			stack.pop_back();
+			if(heap_rank_[id] != NONE) { continue; }
+			heap_rank_[id] = order.size();
+			order.push_back(id);
+			heap_comp_.push_back(num_comps);
+			for(int32_t m = 7; m >= 0; m--)
+			{
+				uint32_t nid = step(id, m);
+				if((moves[id] & (1 << m)) && heap_rank_[nid] == NONE)
+				{
+					stack.push_back(nid);
+				}
+			}
+		}
+		num_comps++;
+	}
+	num_nodes_ = order.size();
+	if(num_nodes_ > warthog::rle::MAX_INDEX)
+	{
+		std::cerr << "err; too many nodes for a path database. aborting\n";
+		exit(1);
+	}
+
+	// one table per source. each thread claims the next source, runs a
+	// search and compresses the first moves, in depth-first order
+	std::vector< std::vector<warthog::rle::run> > tables(num_nodes_);
+	std::atomic<uint32_t> next(0);
+	std::atomic<uint32_t> done(0);
+	std::thread::id owner = std::this_thread::get_id();
+	uint32_t last_report = 0;
+	std::function<void()> work = [&]() {
+		warthog::first_move_search search(moves, width_);
+		std::vector<uint8_t> masks(num_nodes_);
+		for(uint32_t src = next.fetch_add(1); src < num_nodes_;
+				src = next.fetch_add(1))
+		{
+			search.run(order[src]);
+			for(uint32_t i = 0; i < num_nodes_; i++)
+			{
+				masks[i] = search.get_first_moves(order[i]);
+			}
+			warthog::rle::encode(&masks[0], num_nodes_, tables[src]);
+			tables[src].shrink_to_fit();
+
+			uint32_t finished = done.fetch_add(1) + 1;
+			if(progress && std::this_thread::get_id() == owner &&
+					(uint64_t)(finished - last_report)*100 >= num_nodes_)
+			{
+				progress(finished, num_nodes_);
+				last_report = finished;
+			}
+		}
+	};
+
+	std::vector<std::thread*> threads;
+	for(uint32_t i = 1; i < nthreads && i < num_nodes_; i++)
+	{
+		threads.push_back(new std::thread(work));
+	}
+	work();
+	for(uint32_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->join();
+		delete threads[i];
+	}
+	if(progress) { progress(num_nodes_, num_nodes_); }
+
+	heap_offsets_.assign(num_nodes_ + 1, 0);
+	for(uint32_t i = 0; i < num_nodes_; i++)
+	{
+		heap_offsets_[i+1] = heap_offsets_[i] + tables[i].size();
+	}
+	num_runs_ = heap_offsets_[num_nodes_];
+	heap_runs_.reserve(num_runs_);
+	for(uint32_t i = 0; i < num_nodes_; i++)
+	{
+		heap_runs_.insert(heap_runs_.end(), tables[i].begin(), tables[i].end());
+		std::vector<warthog::rle::run>().swap(tables[i]);
+	}
+
+	offsets_ = &heap_offsets_[0];
+	rank_ = &heap_rank_[0];
+	comp_ = heap_comp_.size() ? &heap_comp_[0] : 0;
+	runs_ = heap_runs_.size() ? &heap_runs_[0] : 0;
+}
+
+bool
+warthog::cpd::save()
+{
+	uint64_t params[warthog::mapped_db_ns::NUM_PARAMS] =
+		{ num_nodes_, num_runs_ };
+	warthog::mapped_db_ns::block blocks[4] = {
+		{ offsets_, sizeof(uint64_t) * ((size_t)num_nodes_ + 1) },
+		{ rank_, sizeof(uint32_t) * map_->padded_mapsize() },
+		{ comp_, sizeof(uint32_t) * (size_t)num_nodes_ },
+		{ runs_, sizeof(warthog::rle::run) * (size_t)num_runs_ } };
+	return file_.save(params, blocks, 4);
+}
+
+size_t
+warthog::cpd::mem()
+{
+	return sizeof(*this) +
+		db_size(num_nodes_, num_runs_, map_->padded_mapsize());
+}
+
+double
+warthog::cpd_query::get_path(warthog::sn_id_t startid,
+		warthog::sn_id_t goalid, std::vector<warthog::sn_id_t>& path)
+{
+	path.clear();
+	return walk(startid, goalid, &path);
+}
+
+double
+warthog::cpd_query::get_length(warthog::sn_id_t startid,
+		warthog::sn_id_t goalid)
+{
+	return walk(startid, goalid, 0);
+}
+
+double
+warthog::cpd_query::walk(warthog::sn_id_t startid, warthog::sn_id_t goalid,
+		std::vector<warthog::sn_id_t>* path)
+{
+	warthog::timer mytimer;
+	mytimer.start();
+	moves_ = 0;
+
+	warthog::cost_t len = 0;
+	if(!db_->is_traversable(startid) || !db_->is_traversable(goalid))
+	{
+		len = warthog::COST_MAX;
+	}
+	else
+	{
+		if(path) { path->push_back(startid); }
+		for(warthog::sn_id_t id = startid; id != goalid; )
+		{
+			uint32_t move = db_->get_move(id, goalid);
+			moves_++;
+			if(move == warthog::cpd::NONE)
+			{
+				if(path) { path->clear(); }
+				len = warthog::COST_MAX;
+				break;
+			}
+			len += db_->move_cost(move);
+			id = db_->step(id, move);
+			if(path) { path->push_back(id); }
+		}
+	}
+
+	mytimer.stop();
+	search_time_ = mytimer.elapsed_time_micro();
+	return len / (double)warthog::ONE;
+}
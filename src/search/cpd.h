@@ -0,0 +1,216 @@
+#ifndef WARTHOG_CPD_H
+#define WARTHOG_CPD_H
+
+// cpd.h
+//
+// A compressed path database (CPD) for uniform-cost grid maps. For every
+// traversable tile s the database records, for every other tile t, the
+// first move of an optimal path from s to t. Paths are then extracted one
+// move at a time, without search: from s, look up the first move toward
+// t, take it and repeat from the tile reached.
+//
+// Each table (one per source) is computed with a Dijkstra search that
+// tracks, for every tile, the set of optimal first moves (see
+// warthog::first_move_search). Tables are
+// compressed with warthog::rle. Tiles are numbered in depth-first order
+// (each tile follows one of its neighbours where possible) so that tiles
+// with the same first move tend to have consecutive numbers; runs are
+// long, the more so as the encoder may pick any optimal move for each
+// tile and any move at all for unreachable tiles. A query is a binary
+// search in the runs of the current tile.
+//
+// Tables are built in parallel (each thread runs its own Dijkstra
+// searches) and stored next to the map, in a file with the suffix .cpd.
+// The file has the format of warthog::mapped_db: a header that is checked
+// against the current map and a payload that is mapped read-only into
+// memory (mmap) when loaded. The payload holds, in order: the offset of
+// every table in the array of runs, the number of every tile (by padded
+// id; NONE for obstacles), the connected component of every tile (by
+// number) and the runs.
+//
+// Moves obey the usual rules for grid maps: diagonal moves may not cut
+// corners. Preprocessing takes time and space quadratic in the number of
+// traversable tiles and is best suited to small and medium-sized maps.
+//
+// Thread safety: after construction the database is read-only; queries
+// from different threads need only their own warthog::cpd_query.
+//
+// Theoretical details:
+// [Botea A., 2011, Ultra-fast Optimal Pathfinding without Runtime Search,
+// AIIDE]
+// [Strasser B., Botea A. and Harabor D., 2015, Compressing Optimal Paths
+// with Run Length Encoding, JAIR]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "constants.h"
+#include "first_move_search.h"
+#include "gridmap.h"
+#include "jpsplus_preproc.h"
+#include "mapped_db.h"
+#include "rle.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace warthog
+{
+
+namespace cpd_ns
+{
+	static const uint32_t VERSION = 1;
+
+	// moves, in order: N, S, E, W, NE, NW, SE, SW
+	using warthog::first_move_ns::DX;
+	using warthog::first_move_ns::DY;
+}
+
+class cpd
+{
+	public:
+		// no such tile (an obstacle) or no such move (no path)
+		static const uint32_t NONE = 0xffffffff;
+
+		// the database is loaded from disk or, if no valid copy exists,
+		// computed using @param nthreads threads (0 = one per core) and
+		// saved. @param progress, if given, is called as preprocessing
+		// advances.
+		cpd(warthog::gridmap* map, uint32_t nthreads = 0,
+				warthog::jpsplus_preproc::progress_fn progress =
+				warthog::jpsplus_preproc::progress_fn());
+		~cpd();
+
+		// @return the first move (an index into cpd_ns::DX and cpd_ns::DY)
+		// on an optimal path between the tiles with (padded) ids
+		// @param from and @param to, or ::NONE if there is no such path
+		// or the two are the same
+		inline uint32_t
+		get_move(warthog::sn_id_t from, warthog::sn_id_t to)
+		{
+			uint32_t src = rank_[from];
+			uint32_t dst = rank_[to];
+			if(src == NONE || dst == NONE || src == dst ||
+					comp_[src] != comp_[dst])
+			{
+				return NONE;
+			}
+			return warthog::rle::decode(
+					runs_ + offsets_[src], runs_ + offsets_[src+1], dst);
+		}
+
+		inline bool
+		is_traversable(warthog::sn_id_t id) { return rank_[id] != NONE; }
+
+		// @return the id of the tile one @param move away from @param id
+		inline warthog::sn_id_t
+		step(warthog::sn_id_t id, uint32_t move)
+		{
+			return id + warthog::cpd_ns::DY[move] * (int32_t)width_ +
+				warthog::cpd_ns::DX[move];
+		}
+
+		// @return the cost of @param move
+		inline warthog::cost_t
+		move_cost(uint32_t move)
+		{
+			return move < 4 ? warthog::ONE : warthog::ROOT_TWO;
+		}
+
+		// number of tiles with a first-move table
+		inline uint32_t
+		num_nodes() { return num_nodes_; }
+
+		inline uint64_t
+		num_runs() { return num_runs_; }
+
+		// time (in microseconds) spent computing the database;
+		// zero if the database was loaded from disk
+		inline double
+		get_preproc_time() { return preproc_time_; }
+
+		inline const char*
+		filename() { return file_.filename(); }
+
+		size_t
+		mem();
+
+	private:
+		warthog::gridmap* map_;
+		uint32_t width_;
+		uint32_t num_nodes_;
+		uint64_t num_runs_;
+		double preproc_time_;
+
+		// the database, in a mapped file or in the vectors below
+		warthog::mapped_db file_;
+		const uint64_t* offsets_;
+		const uint32_t* rank_;
+		const uint32_t* comp_;
+		const warthog::rle::run* runs_;
+		std::vector<uint64_t> heap_offsets_;
+		std::vector<uint32_t> heap_rank_;
+		std::vector<uint32_t> heap_comp_;
+		std::vector<warthog::rle::run> heap_runs_;
+
+		bool
+		load();
+
+		void
+		compute(uint32_t nthreads,
+				warthog::jpsplus_preproc::progress_fn& progress);
+
+		bool
+		save();
+
+		// no copy
+		cpd(const cpd& other) : file_(0, "", 0, 0, "") { }
+		cpd&
+		operator=(const cpd& other) { return *this; }
+};
+
+// extracts paths from a warthog::cpd and keeps the statistics of the last
+// query, with the same accessors as the search algorithms.
+class cpd_query
+{
+	public:
+		cpd_query(warthog::cpd* db) : db_(db), moves_(0), search_time_(0)
+		{ }
+
+		// the path is written to @param path (which is cleared first) as
+		// a sequence of (padded) ids, from start to goal.
+		// @return the length of the path (warthog::COST_MAX / 
+		// warthog::ONE if there is none)
+		double
+		get_path(warthog::sn_id_t startid, warthog::sn_id_t goalid,
+				std::vector<warthog::sn_id_t>& path);
+
+		// as above, without recording the path
+		double
+		get_length(warthog::sn_id_t startid, warthog::sn_id_t goalid);
+
+		// the number of moves looked up by the last query
+		inline uint32_t
+		get_moves() { return moves_; }
+
+		inline double
+		get_search_time() { return search_time_; }
+
+		inline size_t
+		mem() { return sizeof(*this); }
+
+	private:
+		warthog::cpd* db_;
+		uint32_t moves_;
+		double search_time_;
+
+		double
+		walk(warthog::sn_id_t startid, warthog::sn_id_t goalid,
+				std::vector<warthog::sn_id_t>* path);
+};
+
+}
+
+#endif
@@ -0,0 +1,534 @@
+#ifndef WARTHOG_DSTAR_LITE_H
+#define WARTHOG_DSTAR_LITE_H
+
+// dstar_lite.h
+//
+// Incremental search for grid maps whose tiles change over time (e.g.
+// doors open or buildings are placed). Paths are computed with D* Lite:
+// the search runs backward, from the goal toward the agent, and its search
+// tree is kept from one query to the next. When the agent moves or the map
+// changes, only the affected portion of the tree is repaired.
+//
+// Every tile has a g-value (the cost of the best path to the goal found
+// so far) and a one-step lookahead value, rhs. Tiles where the two differ
+// are inconsistent and wait on a priority queue, ordered by the pair
+// [min(g, rhs) + h(start, n) + km, min(g, rhs)]. km accumulates the
+// heuristic distance travelled by the agent, so that keys computed for an
+// earlier start remain lower bounds.
+//
+// Map edits are applied in batches, with ::set_labels. Changing the label
+// of a tile t affects only edges between tiles in the 3x3 square centred
+// on t (diagonal moves may not cut corners) so only the rhs values of those
+// tiles are recomputed. A query for a new goal discards the search tree.
+//
+// Requirements: the expansion policy E must generate the same edges, at
+// the same costs, in both directions (e.g. warthog::gridmap_expansion_policy
+// and warthog::wgridmap_expansion_policy, which read map M) and the
+// heuristic H must be consistent. Tiles with label 0 are obstacles.
+//
+// Given a warthog::component_index (::set_component_index), queries 
+// between different connected components are answered without search 
+// (and without discarding the search tree) and ::set_labels keeps the 
+// index up to date.
+//
+// Theoretical details:
+// [Koenig S. and Likhachev M., 2002, D* Lite, AAAI]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "component_index.h"
+#include "constants.h"
+#include "problem_instance.h"
+#include "search_node.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace warthog
+{
+
+// a batch of map edits: each entry is a (padded) tile id and its new label
+typedef std::vector< std::pair<warthog::sn_id_t, warthog::dbword> >
+	label_batch;
+
+// H is a heuristic function
+// E is an expansion policy
+// M is the map read by E
+template <class H, class E, class M>
+class dstar_lite
+{
+	public:
+		dstar_lite(H* heuristic, E* expander, M* map)
+			: heuristic_(heuristic), expander_(expander), map_(map),
+			verbose_(false), hscale_(1.0), searchid_(0),
+			start_(warthog::INF), goal_(warthog::INF), last_(warthog::INF),
+			km_(0), components_(0)
+		{
+			size_ = (size_t)map->height() * map->width();
+			g_ = new warthog::cost_t[size_];
+			rhs_ = new warthog::cost_t[size_];
+			pos_ = new uint32_t[size_];
+			stamp_ = new uint32_t[size_];
+			for(size_t i = 0; i < size_; i++) { stamp_[i] = 0; }
+			reset_stats();
+			pending_ = false;
+		}
+
+		~dstar_lite()
+		{
+			delete [] g_;
+			delete [] rhs_;
+			delete [] pos_;
+			delete [] stamp_;
+		}
+
+		// the path is written to @param path (which is cleared first) as
+		// a sequence of (padded) ids, from start to goal.
+		// @return the length of the path
+		double
+		get_path(warthog::sn_id_t startid, warthog::sn_id_t goalid,
+				std::vector<warthog::sn_id_t>& path)
+		{
+			path.clear();
+			warthog::cost_t len = search(startid, goalid);
+			if(len == warthog::COST_MAX) { return len / (double)warthog::ONE; }
+
+			// descend the g-values from the start
+			warthog::sn_id_t ids[8];
+			warthog::cost_t costs[8];
+			warthog::sn_id_t current = startid;
+			path.push_back(current);
+			while(current != goalid)
+			{
+				uint32_t num = successors(current, ids, costs);
+				warthog::cost_t best = warthog::COST_MAX;
+				for(uint32_t i = 0; i < num; i++)
+				{
+					warthog::cost_t val = add(costs[i], g(ids[i]));
+					if(val < best) { best = val; current = ids[i]; }
+				}
+				path.push_back(current);
+			}
+			return len / (double)warthog::ONE;
+		}
+
+		double
+		get_length(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			warthog::cost_t len = search(startid, goalid);
+			return len / (double)warthog::ONE;
+		}
+
+		// set the label of each tile in @param changes and repair the
+		// search tree. the repair is completed lazily, by the next query,
+		// and the statistics for that query include the work done here.
+		void
+		set_labels(warthog::label_batch& changes)
+		{
+			if(!pending_) { reset_stats(); }
+			pending_ = true;
+			warthog::timer mytimer;
+			mytimer.start();
+
+			for(uint32_t i = 0; i < changes.size(); i++)
+			{
+				if(components_)
+				{
+					components_->set_label(changes[i].first, changes[i].second);
+				}
+				else { map_->set_label(changes[i].first, changes[i].second); }
+			}
+			uint32_t width = map_->width();
+			for(uint32_t i = 0; goal_ != warthog::INF && i < changes.size(); i++)
+			{
+				warthog::sn_id_t centre = changes[i].first;
+				for(int32_t dy = -1; dy <= 1; dy++)
+				{
+					for(int32_t dx = -1; dx <= 1; dx++)
+					{
+						update_vertex(centre + dy*(int64_t)width + dx);
+					}
+				}
+			}
+
+			mytimer.stop();
+			search_time_ += mytimer.elapsed_time_micro();
+		}
+
+		// discard the search tree; the next query starts from scratch
+		inline void
+		reset() { goal_ = warthog::INF; }
+
+		inline size_t
+		mem()
+		{
+			return sizeof(*this) +
+				size_ * (2*sizeof(warthog::cost_t) + 2*sizeof(uint32_t)) +
+				open_.capacity() * sizeof(entry) + expander_->mem();
+		}
+
+		// statistics for the last query
+		inline uint32_t
+		get_nodes_expanded() { return nodes_expanded_; }
+
+		inline uint32_t
+		get_nodes_generated() { return nodes_generated_; }
+
+		inline uint32_t
+		get_nodes_touched() { return nodes_touched_; }
+
+		inline double
+		get_search_time() { return search_time_; }
+
+		inline bool
+		get_verbose() { return verbose_; }
+
+		inline void
+		set_verbose(bool verbose) { verbose_ = verbose; }
+
+		inline double
+		get_hscale() { return hscale_; }
+
+		inline void
+		set_hscale(double hscale) { hscale_ = hscale; reset(); }
+
+		// @param components must index map M
+		inline void
+		set_component_index(warthog::component_index* components)
+		{
+			components_ = components;
+		}
+
+	private:
+		static const uint32_t NOT_QUEUED = 0xffffffff;
+
+		struct entry
+		{
+			warthog::cost_t k1;
+			warthog::cost_t k2;
+			warthog::sn_id_t id;
+		};
+
+		H* heuristic_;
+		E* expander_;
+		M* map_;
+		bool verbose_;
+		double hscale_;
+		warthog::problem_instance instance_;
+
+		// per-tile state. values are valid only if stamp_ == searchid_
+		size_t size_;
+		warthog::cost_t* g_;
+		warthog::cost_t* rhs_;
+		uint32_t* pos_; // index into open_ or NOT_QUEUED
+		uint32_t* stamp_;
+		uint32_t searchid_;
+
+		// the priority queue (a binary heap)
+		std::vector<entry> open_;
+
+		warthog::sn_id_t start_;
+		warthog::sn_id_t goal_;
+		warthog::sn_id_t last_; // the start when km_ was last updated
+		warthog::cost_t km_;
+		warthog::component_index* components_;
+
+		uint32_t nodes_expanded_;
+		uint32_t nodes_generated_;
+		uint32_t nodes_touched_;
+		double search_time_;
+		bool pending_; // map edits since the last query
+
+		// no copy
+		dstar_lite(const dstar_lite& other) { }
+		dstar_lite&
+		operator=(const dstar_lite& other) { return *this; }
+
+		// @return the cost of an optimal path from @param startid to
+		// @param goalid or warthog::COST_MAX if there is no path
+		warthog::cost_t
+		search(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			if(!pending_) { reset_stats(); }
+			pending_ = false;
+			warthog::timer mytimer;
+			mytimer.start();
+			if(components_ && !components_->reachable(startid, goalid))
+			{
+				mytimer.stop();
+				search_time_ += mytimer.elapsed_time_micro();
+				return warthog::COST_MAX;
+			}
+
+			if(goalid != goal_)
+			{
+				// a new search tree, rooted at the goal
+				// NB: stamp 0 is reserved for untouched tiles
+				searchid_++;
+				open_.clear();
+				goal_ = goalid;
+				start_ = last_ = startid;
+				km_ = 0;
+				rhs(goal_) = 0;
+				push(goal_);
+			}
+			else if(startid != start_)
+			{
+				start_ = startid;
+				km_ += h(last_, start_);
+				last_ = start_;
+			}
+			compute_shortest_path();
+
+			mytimer.stop();
+			search_time_ += mytimer.elapsed_time_micro();
+			return g(start_);
+		}
+
+		inline void
+		reset_stats()
+		{
+			nodes_expanded_ = nodes_generated_ = nodes_touched_ = 0;
+			search_time_ = 0;
+		}
+
+		void
+		compute_shortest_path()
+		{
+			warthog::sn_id_t ids[8];
+			warthog::cost_t costs[8];
+			while(open_.size() &&
+					(less(open_[0], key(start_)) ||
+					 rhs(start_) != g(start_)))
+			{
+				entry top = open_[0];
+				entry fresh = key(top.id);
+				if(less(top, fresh))
+				{
+					// the start moved since top was queued
+					open_[0] = fresh;
+					sift_down(0);
+					continue;
+				}
+
+				warthog::sn_id_t u = top.id;
+				nodes_expanded_++;
+				uint32_t num = successors(u, ids, costs);
+				if(g(u) > rhs(u))
+				{
+					// overconsistent: settle u
+					g(u) = rhs(u);
+					remove(u);
+					for(uint32_t i = 0; i < num; i++)
+					{
+						warthog::sn_id_t s = ids[i];
+						warthog::cost_t val = add(costs[i], g(u));
+						if(s != goal_ && val < rhs(s))
+						{
+							rhs(s) = val;
+							update_vertex(s, false);
+						}
+					}
+				}
+				else
+				{
+					// underconsistent: u and the tiles whose rhs came
+					// from u need new values
+					warthog::cost_t g_old = g(u);
+					g(u) = warthog::COST_MAX;
+					for(uint32_t i = 0; i < num; i++)
+					{
+						if(rhs(ids[i]) == add(costs[i], g_old))
+						{
+							update_vertex(ids[i]);
+						}
+					}
+					update_vertex(u);
+				}
+			}
+		}
+
+		// recompute (if @param recompute) the rhs value of @param u and
+		// add, remove or requeue u depending on whether it is consistent
+		void
+		update_vertex(warthog::sn_id_t u, bool recompute = true)
+		{
+			if(recompute && u != goal_)
+			{
+				warthog::sn_id_t ids[8];
+				warthog::cost_t costs[8];
+				uint32_t num = successors(u, ids, costs);
+				warthog::cost_t best = warthog::COST_MAX;
+				for(uint32_t i = 0; i < num; i++)
+				{
+					warthog::cost_t val = add(costs[i], g(ids[i]));
+					if(val < best) { best = val; }
+				}
+				rhs(u) = best;
+			}
+
+			bool queued = pos_[u] != NOT_QUEUED;
+			if(g(u) != rhs(u))
+			{
+				if(queued)
+				{
+					uint32_t index = pos_[u];
+					open_[index] = key(u);
+					sift_up(index);
+					sift_down(pos_[u]);
+				}
+				else { push(u); }
+			}
+			else if(queued) { remove(u); }
+		}
+
+		// write the neighbours of tile @param id, and the cost of reaching
+		// each one, into @param ids and @param costs.
+		// @return the number of neighbours
+		inline uint32_t
+		successors(warthog::sn_id_t id, warthog::sn_id_t ids[8],
+				warthog::cost_t costs[8])
+		{
+			// NB: obstacles have no edges (some policies generate moves
+			// out of an obstacle, but never into one)
+			if(!map_->get_label(id)) { return 0; }
+
+			expander_->expand(expander_->generate(id), &instance_);
+			uint32_t num = 0;
+			warthog::search_node* n = 0;
+			warthog::cost_t cost = warthog::COST_MAX;
+			for(expander_->first(n, cost); n != 0; expander_->next(n, cost))
+			{
+				ids[num] = n->get_id();
+				costs[num] = cost;
+				num++;
+			}
+			nodes_touched_ += num;
+			return num;
+		}
+
+		// initialise the state of tile @param id if this is the first
+		// time it is seen by the current search tree
+		inline void
+		touch(warthog::sn_id_t id)
+		{
+			if(stamp_[id] != searchid_)
+			{
+				stamp_[id] = searchid_;
+				g_[id] = rhs_[id] = warthog::COST_MAX;
+				pos_[id] = NOT_QUEUED;
+			}
+		}
+
+		inline warthog::cost_t&
+		g(warthog::sn_id_t id) { touch(id); return g_[id]; }
+
+		inline warthog::cost_t&
+		rhs(warthog::sn_id_t id) { touch(id); return rhs_[id]; }
+
+		inline warthog::cost_t
+		h(warthog::sn_id_t from, warthog::sn_id_t to)
+		{
+			return heuristic_->h(from, to) * hscale_;
+		}
+
+		// @return the sum of two costs, either of which may be infinite
+		inline warthog::cost_t
+		add(warthog::cost_t a, warthog::cost_t b)
+		{
+			if(a == warthog::COST_MAX || b == warthog::COST_MAX)
+			{
+				return warthog::COST_MAX;
+			}
+			return a + b;
+		}
+
+		inline entry
+		key(warthog::sn_id_t id)
+		{
+			entry e;
+			e.id = id;
+			e.k2 = std::min(g(id), rhs(id));
+			e.k1 = add(e.k2, h(start_, id) + km_);
+			return e;
+		}
+
+		// lexicographic order on [k1, k2]
+		inline bool
+		less(const entry& a, const entry& b)
+		{
+			return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+		}
+
+		inline void
+		push(warthog::sn_id_t id)
+		{
+			touch(id);
+			open_.push_back(key(id));
+			pos_[id] = open_.size() - 1;
+			sift_up(open_.size() - 1);
+			nodes_generated_++;
+		}
+
+		inline void
+		remove(warthog::sn_id_t id)
+		{
+			uint32_t index = pos_[id];
+			if(index == NOT_QUEUED) { return; }
+			pos_[id] = NOT_QUEUED;
+			entry last = open_.back();
+			open_.pop_back();
+			if(index == open_.size()) { return; }
+
+			open_[index] = last;
+			pos_[last.id] = index;
+			sift_up(index);
+			sift_down(pos_[last.id]);
+		}
+
+		inline void
+		sift_up(uint32_t index)
+		{
+			entry e = open_[index];
+			while(index > 0)
+			{
+				uint32_t parent = (index - 1) >> 1;
+				if(!less(e, open_[parent])) { break; }
+				open_[index] = open_[parent];
+				pos_[open_[index].id] = index;
+				index = parent;
+			}
+			open_[index] = e;
+			pos_[e.id] = index;
+		}
+
+		inline void
+		sift_down(uint32_t index)
+		{
+			entry e = open_[index];
+			uint32_t size = open_.size();
+			while(true)
+			{
+				uint32_t child = 2*index + 1;
+				if(child >= size) { break; }
+				if(child+1 < size && less(open_[child+1], open_[child]))
+				{
+					child++;
+				}
+				if(!less(open_[child], e)) { break; }
+				open_[index] = open_[child];
+				pos_[open_[index].id] = index;
+				index = child;
+			}
+			open_[index] = e;
+			pos_[e.id] = index;
+		}
+};
+
+}
+
+#endif
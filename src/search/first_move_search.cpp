@@ -0,0 +1,70 @@
+#include "first_move_search.h"
+#include "gridmap.h"
+
+#include <algorithm>
+
+std::vector<uint8_t>
+warthog::first_move_ns::legal_moves(warthog::gridmap* map)
+{
+	uint32_t width = map->width();
+	std::vector<uint8_t> moves(map->padded_mapsize(), 0);
+	for(uint32_t id = width; id < map->padded_mapsize() - width; id++)
+	{
+		if(!map->get_label(id)) { continue; }
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			int32_t dx = warthog::first_move_ns::DX[m];
+			int32_t dy = warthog::first_move_ns::DY[m];
+			if(map->get_label(id + dy*(int32_t)width + dx) &&
+				map->get_label(id + dx) &&
+				map->get_label(id + dy*(int32_t)width))
+			{
+				moves[id] |= (1 << m);
+			}
+		}
+	}
+	return moves;
+}
+
+warthog::first_move_search::first_move_search(
+		std::vector<uint8_t>& moves, uint32_t width)
+	: moves_(moves), width_(width), searchid_(0),
+	dist_(moves.size()), stamp_(moves.size(), 0), first_(moves.size(), 0)
+{ }
+
+void
+warthog::first_move_search::run(uint32_t source)
+{
+	searchid_++;
+	heap_.clear();
+	reached_.clear();
+	touch(source, 0, 0);
+	heap_.push_back(entry(0, source));
+
+	while(heap_.size())
+	{
+		std::pop_heap(heap_.begin(), heap_.end(), cmp_);
+		entry e = heap_.back();
+		heap_.pop_back();
+		uint32_t id = e.second;
+		if(e.first > dist_[id]) { continue; }
+		reached_.push_back(id);
+
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			if(!(moves_[id] & (1 << m))) { continue; }
+			uint32_t nid = id + warthog::first_move_ns::DY[m]*(int32_t)width_ +
+				warthog::first_move_ns::DX[m];
+			warthog::cost_t g = e.first +
+				(m < 4 ? warthog::ONE : warthog::ROOT_TWO);
+			uint8_t first = id == source ? (1 << m) : first_[id];
+			if(stamp_[nid] != searchid_ || g < dist_[nid])
+			{
+				touch(nid, g, first);
+				heap_.push_back(entry(g, nid));
+				std::push_heap(heap_.begin(), heap_.end(), cmp_);
+			}
+			else if(g == dist_[nid]) { first_[nid] |= first; }
+		}
+	}
+}
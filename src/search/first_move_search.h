@@ -0,0 +1,92 @@
+#ifndef WARTHOG_FIRST_MOVE_SEARCH_H
+#define WARTHOG_FIRST_MOVE_SEARCH_H
+
+// first_move_search.h
+//
+// A Dijkstra search, from a single source, over a uniform-cost grid map
+// which records, for every tile reached, the set of moves out of the
+// source that begin an optimal path to it. This is the preprocessing step
+// shared by the databases built on all-pairs first moves: compressed path
+// databases (warthog::cpd) and goal bounding (warthog::goal_bounding).
+//
+// The map is described by the moves that can be made from each tile (see
+// first_move_ns::legal_moves); diagonal moves may not cut corners. A
+// single instance is reused for many sources; each thread needs its own.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "constants.h"
+#include "gridmap.h"
+
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace warthog
+{
+
+
+namespace first_move_ns
+{
+	// moves, in order: N, S, E, W, NE, NW, SE, SW
+	// (the same order as the bits of warthog::jps::direction)
+	static const int32_t DX[8] = { 0, 0, 1, -1,  1, -1, 1, -1};
+	static const int32_t DY[8] = {-1, 1, 0,  0, -1, -1, 1,  1};
+
+	// the moves that can be made from each tile of @param map, by padded
+	// id (bit i = move i)
+	std::vector<uint8_t>
+	legal_moves(warthog::gridmap* map);
+}
+
+class first_move_search
+{
+	public:
+		// @param moves, as returned by first_move_ns::legal_moves, must
+		// outlive the search
+		first_move_search(std::vector<uint8_t>& moves, uint32_t width);
+
+		void
+		run(uint32_t source);
+
+		// @return the optimal first moves toward @param id (0 if @param id
+		// was not reached or is the source)
+		inline uint8_t
+		get_first_moves(uint32_t id)
+		{
+			return stamp_[id] == searchid_ ? first_[id] : 0;
+		}
+
+		// @return the tiles reached by the last search, in the order in
+		// which they were settled (the source first)
+		inline const std::vector<uint32_t>&
+		get_reached() { return reached_; }
+
+	private:
+		typedef std::pair<warthog::cost_t, uint32_t> entry;
+
+		std::vector<uint8_t>& moves_;
+		uint32_t width_;
+		uint32_t searchid_;
+		std::vector<warthog::cost_t> dist_;
+		std::vector<uint32_t> stamp_;
+		std::vector<uint8_t> first_;
+		std::vector<entry> heap_;
+		std::vector<uint32_t> reached_;
+		std::greater<entry> cmp_;
+
+		inline void
+		touch(uint32_t id, warthog::cost_t g, uint8_t first)
+		{
+			stamp_[id] = searchid_;
+			dist_[id] = g;
+			first_[id] = first;
+		}
+};
+
+}
+
+#endif
@@ -5,42 +5,100 @@
 //
 // A* implementation that allows arbitrary combinations of 
 // (weighted) heuristic functions and node expansion policies.
-// This implementation uses a binary heap for the open_ list
-// and a bit array for the closed_ list.
+// By default this implementation uses a binary heap (warthog::pqueue) for 
+// the open_ list; any class with the same interface can be substituted 
+// (e.g. warthog::radix_heap). Closed nodes are marked as expanded.
 //
 // TODO: is it better to store a separate closed list and ungenerate nodes
 // or use more memory and not ungenerate until the end of search??
 // 32bytes vs... whatever unordered_map overhead is a two integer key/value pair
+//
+// Thread safety: an instance of this class is a self-contained search 
+// context. Distinct instances can run concurrently in different threads 
+// provided they do not share an expansion policy (each policy owns a node 
+// pool). The map, the heuristic and any jump point locators passed to 
+// the policies can be shared; see gridmap.h and the locator headers. 
+//
+// Searches can also be time-sliced: ::begin starts a search and each call 
+// to ::step (or ::step_until) expands a bounded number of nodes before 
+// returning. The open list and all generated nodes persist between calls,
+// so one instance (and expansion policy) is needed for every search that 
+// is in progress at the same time. While a search is running, 
+// ::get_best_path returns a path to the generated node that appears 
+// closest to the goal (i.e. has the smallest heuristic value).
+//
+// Every search can be limited by a node budget, a wall clock time limit 
+// and a warthog::cancel_token. A search which exceeds a limit (or whose 
+// token is cancelled) stops with status SEARCH_ABORTED and no path. 
+// The clock and the token are checked once every 32 expansions.
+//
+// Given a warthog::component_index (::set_component_index), searches 
+// between tiles in different connected components end immediately, with
+// status SEARCH_NO_PATH.
 // 
 // @author: dharabor
 // @created: 21/08/2012
 //
 
+#include "cancel_token.h"
+#include "component_index.h"
 #include "cpool.h"
+#include "dary_heap.h"
 #include "pqueue.h"
 #include "problem_instance.h"
 #include "search_node.h"
 #include "timer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <vector>
 
 namespace warthog
 {
 
+// the default open list. compact search nodes (WARTHOG_COMPACT_NODES) do 
+// not store f-values and require an open list that keeps them inline.
+#ifdef WARTHOG_COMPACT_NODES
+typedef warthog::dary_heap<4> default_open_list;
+#else
+typedef warthog::pqueue default_open_list;
+#endif
+
+// the state of a time-sliced search (see flexible_astar::step)
+enum search_status
+{
+	SEARCH_RUNNING, // more nodes remain to be expanded
+	SEARCH_FOUND, // an optimal path to the goal is known
+	SEARCH_NO_PATH, // the open list is exhausted; the goal is unreachable
+	SEARCH_ABORTED // stopped by a search limit or a warthog::cancel_token
+};
+
 // H is a heuristic function
 // E is an expansion policy
-template <class H, class E>
+// Q is the open list
+template <class H, class E, class Q = warthog::default_open_list>
 class flexible_astar 
 {
 	public:
 		flexible_astar(H* heuristic, E* expander)
 			: heuristic_(heuristic), expander_(expander)
 		{
-			open_ = new warthog::pqueue(1024, true);
+			open_ = new Q(1024, true);
 			verbose_ = false;
+			searchid_ = 0;
             hscale_ = 1.0;
+			active_ = false;
+			status_ = warthog::SEARCH_NO_PATH;
+			goal_ = best_ = 0;
+			nodes_expanded_ = nodes_generated_ = nodes_touched_ = 0;
+			search_time_ = 0;
+			node_budget_ = 0;
+			time_limit_ = 0;
+			deadline_nano_ = 0;
+			cancel_ = 0;
+			components_ = 0;
 		}
 
 		~flexible_astar()
@@ -49,10 +107,10 @@ class flexible_astar
 			delete open_;
 		}
 
-		inline std::stack<uint32_t>
-		get_path(uint32_t startid, uint32_t goalid)
+		inline std::stack<warthog::sn_id_t>
+		get_path(warthog::sn_id_t startid, warthog::sn_id_t goalid)
 		{
-			std::stack<uint32_t> path;
+			std::stack<warthog::sn_id_t> path;
 			warthog::search_node* goal = search(startid, goalid);
 			if(goal)
 			{
@@ -60,7 +118,7 @@ class flexible_astar
 				assert(goal->get_id() == goalid);
 				for(warthog::search_node* cur = goal;
 						cur != 0;
-					    cur = cur->get_parent())
+					    cur = parent_of(cur))
 				{
 					path.push(cur->get_id());
 				}
@@ -70,11 +128,31 @@ class flexible_astar
 			return path;
 		}
 
+		// as above, but the path is written to the caller-supplied vector 
+		// @param path (which is cleared first) and its length is returned.
+		// the path is a sequence of (padded) ids, from start to goal.
+		// no memory is allocated once @param path has sufficient capacity.
+		//
+		// when @param expand_jumps is true each edge which spans more than 
+		// one tile (e.g. a jump made by one of the JPS variants) is replaced
+		// with the sequence of tiles it passes through; diagonal steps 
+		// first, then straight steps (as per the canonical ordering of JPS).
+		double
+		get_path(warthog::sn_id_t startid, warthog::sn_id_t goalid, 
+				std::vector<warthog::sn_id_t>& path, bool expand_jumps = false)
+		{
+			warthog::search_node* goal = search(startid, goalid);
+			assert(goal == 0 || goal->get_id() == goalid);
+			warthog::cost_t len = extract_path(goal, path, expand_jumps);
+			cleanup();
+			return len / (double)warthog::ONE;
+		}
+
 		double
-		get_length(uint32_t startid, uint32_t goalid)
+		get_length(warthog::sn_id_t startid, warthog::sn_id_t goalid)
 		{
 			warthog::search_node* goal = search(startid, goalid);
-			warthog::cost_t len = warthog::INF;
+			warthog::cost_t len = warthog::COST_MAX;
 			if(goal)
 			{
 				assert(goal->get_id() == goalid);
@@ -90,15 +168,14 @@ class flexible_astar
 				while(current != 0)	
 				{
 					path.push(current);
-					current = current->get_parent();
+					current = parent_of(current);
 				}
 
 				while(!path.empty())
 				{
 					warthog::search_node* n = path.top();
 					uint32_t x, y;
-					y = (n->get_id() / expander_->mapwidth());
-					x = n->get_id() % expander_->mapwidth();
+					expander_->get_xy(n->get_id(), x, y);
 					std::cerr << "final path: ("<<x<<", "<<y<<")...";
 					n->print(std::cerr);
 					std::cerr << std::endl;
@@ -110,6 +187,88 @@ class flexible_astar
 			return len / (double)warthog::ONE;
 		}
 
+		// begin a time-sliced search from @param startid to @param goalid.
+		// only the start node is generated; see ::step
+		inline void
+		begin(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			start_search(startid, goalid);
+		}
+
+		// expand at most @param max_expansions nodes of the current search.
+		// node counts and search time accumulate from the call to ::begin.
+		inline warthog::search_status
+		step(uint32_t max_expansions)
+		{
+			return resume(max_expansions, 0);
+		}
+
+		// expand nodes of the current search until the monotonic clock 
+		// (warthog::timer::get_time_nano) reaches @param deadline_nano. 
+		// the clock is read once every 32 expansions.
+		inline warthog::search_status
+		step_until(double deadline_nano)
+		{
+			return resume(UINT32_MAX, deadline_nano);
+		}
+
+		// the outcome of the last search (see ::get_path and ::get_length) 
+		// or the state of the current time-sliced search
+		inline warthog::search_status
+		get_status() { return status_; }
+
+		// limits for every subsequent search. each search is aborted after
+		// expanding @param max_expansions nodes (0 = no limit)
+		inline void
+		set_node_budget(uint32_t max_expansions) 
+		{ 
+			node_budget_ = max_expansions; 
+		}
+
+		// each search is aborted @param max_micros microseconds (wall clock) 
+		// after it begins (0 = no limit). for time-sliced searches this 
+		// includes the time between calls to ::step.
+		inline void
+		set_time_limit(double max_micros) { time_limit_ = max_micros; }
+
+		// searches are aborted once @param token is cancelled (null = none). 
+		// the token must outlive every search that uses it.
+		inline void
+		set_cancel_token(warthog::cancel_token* token) { cancel_ = token; }
+
+		// reject queries whose start and goal are in different components 
+		// of @param components (null = no index). see component_index.h
+		inline void
+		set_component_index(warthog::component_index* components)
+		{
+			components_ = components;
+		}
+
+		// @return the id of the goal, if found, or else the generated node 
+		// with the smallest heuristic value (warthog::INF if there is no 
+		// current search)
+		inline warthog::sn_id_t
+		get_best_node()
+		{
+			warthog::search_node* best = goal_ ? goal_ : best_;
+			return best ? best->get_id() : warthog::INF;
+		}
+
+		// the path from the start to ::get_best_node is written to 
+		// @param path, as per ::get_path. @return the length of the path
+		double
+		get_best_path(std::vector<warthog::sn_id_t>& path, 
+				bool expand_jumps = false)
+		{
+			warthog::cost_t len = 
+				extract_path(goal_ ? goal_ : best_, path, expand_jumps);
+			return len / (double)warthog::ONE;
+		}
+
+		// release the open list and nodes of the current search
+		inline void
+		end() { cleanup(); }
+
 		inline size_t
 		mem()
 		{
@@ -153,28 +312,65 @@ class flexible_astar
 	private:
 		H* heuristic_;
 		E* expander_;
-		warthog::pqueue* open_;
+		Q* open_;
 		bool verbose_;
-		static uint32_t searchid_;
+		// search generation counter. nodes generated by the expansion policy
+		// during an earlier search are recognised (and lazily reset) by 
+		// comparing their searchid against this value. each instance keeps 
+		// its own counter; nodes are never shared between instances.
+		uint32_t searchid_;
 		uint32_t nodes_expanded_;
 		uint32_t nodes_generated_;
 		uint32_t nodes_touched_;
 		double search_time_;
         double hscale_; // heuristic scaling factor
 
+		// the current search
+		warthog::problem_instance instance_;
+		bool active_; // true until the nodes of the search are released
+		warthog::search_status status_;
+		warthog::search_node* goal_;
+		// the generated node with the smallest heuristic value
+		warthog::search_node* best_;
+		warthog::cost_t best_h_;
+
+		// search limits (0 = no limit)
+		uint32_t node_budget_;
+		double time_limit_; // microseconds
+		double deadline_nano_; // of the current search
+		warthog::cancel_token* cancel_;
+		warthog::component_index* components_;
+
 		// no copy
 		flexible_astar(const flexible_astar& other) { } 
 		flexible_astar& 
 		operator=(const flexible_astar& other) { return *this; }
 
 		warthog::search_node*
-		search(uint32_t startid, uint32_t goalid)
+		search(warthog::sn_id_t startid, warthog::sn_id_t goalid)
+		{
+			start_search(startid, goalid);
+			resume(UINT32_MAX, 0);
+			assert(status_ != warthog::SEARCH_RUNNING);
+			return goal_;
+		}
+
+		// initialise a search from @param startid to @param goalid. 
+		// the previous search, if unfinished, is discarded.
+		void
+		start_search(warthog::sn_id_t startid, warthog::sn_id_t goalid)
 		{
+			if(active_) { cleanup(); }
 			nodes_expanded_ = nodes_generated_ = nodes_touched_ = 0;
 			search_time_ = 0;
 
 			warthog::timer mytimer;
 			mytimer.start();
+			deadline_nano_ = 0;
+			if(time_limit_ != 0)
+			{
+				deadline_nano_ = mytimer.get_time_nano() + time_limit_*1000;
+			}
 
 			#ifndef NDEBUG
 			if(verbose_)
@@ -184,20 +380,53 @@ class flexible_astar
 			}
 			#endif
 
-			warthog::problem_instance instance;
-			instance.set_goal(goalid);
-			instance.set_start(startid);
-			instance.set_searchid(searchid_++);
+			instance_.set_goal(goalid);
+			instance_.set_start(startid);
+			// NB: searchid 0 is reserved for freshly allocated nodes 
+			instance_.set_searchid(++searchid_);
+			active_ = true;
+			status_ = warthog::SEARCH_RUNNING;
+			goal_ = 0;
+			if(components_ && !components_->reachable(startid, goalid))
+			{
+				status_ = warthog::SEARCH_NO_PATH;
+				mytimer.stop();
+				search_time_ += mytimer.elapsed_time_micro();
+				return;
+			}
 
-			warthog::search_node* goal = 0;
 			warthog::search_node* start = expander_->generate(startid);
-			start->reset(instance.get_searchid());
+			start->reset(instance_.get_searchid());
 			start->set_g(0);
-			start->set_f(heuristic_->h(startid, goalid) * hscale_);
-			open_->push(start);
+			best_ = start;
+			best_h_ = heuristic_->h(startid, goalid) * hscale_;
+			push(start, best_h_);
 
-			while(open_->size())
+			mytimer.stop();
+			search_time_ += mytimer.elapsed_time_micro();
+		}
+
+		// continue the current search until the goal is found, the open
+		// list is exhausted, a search limit is exceeded, @param 
+		// max_expansions nodes have been expanded or the clock passes 
+		// @param deadline_nano (0 means no deadline). the last two 
+		// conditions only suspend the search.
+		warthog::search_status
+		resume(uint32_t max_expansions, double deadline_nano)
+		{
+			warthog::timer mytimer;
+			mytimer.start();
+
+			warthog::sn_id_t goalid = instance_.get_goal();
+			for(uint32_t i = 0; status_ == warthog::SEARCH_RUNNING; i++)
 			{
+				if(i == max_expansions) { break; }
+				if(open_->size() == 0)
+				{
+					status_ = warthog::SEARCH_NO_PATH;
+					break;
+				}
+
 				nodes_touched_++;
 				if(open_->peek()->get_id() == goalid)
 				{
@@ -206,120 +435,223 @@ class flexible_astar
 					{
 						uint32_t x, y;
 						warthog::search_node* current = open_->peek();
-						y = (current->get_id() / expander_->mapwidth());
-						x = current->get_id() % expander_->mapwidth();
+						expander_->get_xy(current->get_id(), x, y);
 						std::cerr << "goal found ("<<x<<", "<<y<<")...";
 						current->print(std::cerr);
 						std::cerr << std::endl;
 					}
 					#endif
-					goal = open_->peek();
+					goal_ = open_->peek();
+					status_ = warthog::SEARCH_FOUND;
 					break;
 				}
-				nodes_expanded_++;
-
-				warthog::search_node* current = open_->pop();
-				#ifndef NDEBUG
-				if(verbose_)
+				if(node_budget_ != 0 && nodes_expanded_ >= node_budget_)
 				{
-					uint32_t x, y;
-					y = (current->get_id() / expander_->mapwidth());
-					x = current->get_id() % expander_->mapwidth();
-					std::cerr << "expanding ("<<x<<", "<<y<<")...";
-					current->print(std::cerr);
-					std::cerr << std::endl;
+					status_ = warthog::SEARCH_ABORTED;
+					break;
 				}
-				#endif
-				current->set_expanded(true); // NB: set this before calling expander_ 
-				assert(current->get_expanded());
-				expander_->expand(current, &instance);
-
-				warthog::search_node* n = 0;
-				warthog::cost_t cost_to_n = warthog::INF;
-				for(expander_->first(n, cost_to_n); 
-						n != 0;
-					   	expander_->next(n, cost_to_n))
+				if((i & 31) == 0)
 				{
-					nodes_touched_++;
-					if(n->get_expanded())
+					if(cancel_ && cancel_->is_cancelled())
 					{
-						// skip neighbours already expanded
-						continue;
+						status_ = warthog::SEARCH_ABORTED;
+						break;
 					}
-
-					if(open_->contains(n))
+					if(deadline_nano_ != 0 || deadline_nano != 0)
 					{
-						// update a node from the fringe
-						warthog::cost_t gval = current->get_g() + cost_to_n;
-						if(gval < n->get_g())
+						double now = mytimer.get_time_nano();
+						if(deadline_nano_ != 0 && now >= deadline_nano_)
 						{
-							n->relax(gval, current);
-							open_->decrease_key(n);
-							#ifndef NDEBUG
-							if(verbose_)
-							{
-								uint32_t x, y;
-								y = (n->get_id() / expander_->mapwidth());
-								x = n->get_id() % expander_->mapwidth();
-								std::cerr << "  updating ("<<x<<", "<<y<<")...";
-								n->print(std::cerr);
-								std::cerr << std::endl;
-							}
-							#endif
+							status_ = warthog::SEARCH_ABORTED;
+							break;
 						}
-						else
+						if(deadline_nano != 0 && now >= deadline_nano) { break; }
+					}
+				}
+
+				nodes_expanded_++;
+				expand_next(goalid);
+			}
+
+			mytimer.stop();
+			search_time_ += mytimer.elapsed_time_micro();
+			return status_;
+		}
+
+		// pop the best node from the open list and expand it
+		inline void
+		expand_next(warthog::sn_id_t goalid)
+		{
+			warthog::search_node* current = open_->pop();
+			#ifndef NDEBUG
+			if(verbose_)
+			{
+				uint32_t x, y;
+				expander_->get_xy(current->get_id(), x, y);
+				std::cerr << "expanding ("<<x<<", "<<y<<")...";
+				current->print(std::cerr);
+				std::cerr << std::endl;
+			}
+			#endif
+			current->set_expanded(true); // NB: set this before calling expander_ 
+			assert(current->get_expanded());
+			expander_->expand(current, &instance_);
+
+			warthog::search_node* n = 0;
+			warthog::cost_t cost_to_n = warthog::COST_MAX;
+			for(expander_->first(n, cost_to_n); 
+					n != 0;
+				   	expander_->next(n, cost_to_n))
+			{
+				nodes_touched_++;
+				if(n->get_expanded())
+				{
+					// skip neighbours already expanded
+					continue;
+				}
+
+				if(open_->contains(n))
+				{
+					// update a node from the fringe
+					warthog::cost_t gval = current->get_g() + cost_to_n;
+					if(gval < n->get_g())
+					{
+						n->relax(gval, current);
+						open_->decrease_key(n);
+						#ifndef NDEBUG
+						if(verbose_)
 						{
-							#ifndef NDEBUG
-							if(verbose_)
-							{
-								uint32_t x, y;
-								y = (n->get_id() / expander_->mapwidth());
-								x = n->get_id() % expander_->mapwidth();
-								std::cerr << "  updating ("<<x<<", "<<y<<")...";
-								n->print(std::cerr);
-								std::cerr << std::endl;
-							}
-							#endif
+							uint32_t x, y;
+							expander_->get_xy(n->get_id(), x, y);
+							std::cerr << "  updating ("<<x<<", "<<y<<")...";
+							n->print(std::cerr);
+							std::cerr << std::endl;
 						}
+						#endif
 					}
 					else
 					{
-						// add a new node to the fringe
-						warthog::cost_t gval = current->get_g() + cost_to_n;
-						n->set_g(gval);
-						n->set_f(gval + heuristic_->h(n->get_id(), goalid) * hscale_);
-					   	n->set_parent(current);
-						open_->push(n);
 						#ifndef NDEBUG
 						if(verbose_)
 						{
 							uint32_t x, y;
-							y = (n->get_id() / expander_->mapwidth());
-							x = n->get_id() % expander_->mapwidth();
-							std::cerr << "  generating ("<<x<<", "<<y<<")...";
+							expander_->get_xy(n->get_id(), x, y);
+							std::cerr << "  updating ("<<x<<", "<<y<<")...";
 							n->print(std::cerr);
 							std::cerr << std::endl;
 						}
 						#endif
-						nodes_generated_++;
 					}
 				}
-				#ifndef NDEBUG
-				if(verbose_)
+				else
 				{
-					uint32_t x, y;
-					y = (current->get_id() / expander_->mapwidth());
-					x = current->get_id() % expander_->mapwidth();
-					std::cerr <<"closing ("<<x<<", "<<y<<")...";
-					current->print(std::cerr);
-					std::cerr << std::endl;
+					// add a new node to the fringe
+					warthog::cost_t gval = current->get_g() + cost_to_n;
+					n->set_g(gval);
+				   	n->set_parent(current);
+					warthog::cost_t hval = 
+						heuristic_->h(n->get_id(), goalid) * hscale_;
+					push(n, gval + hval);
+					if(hval < best_h_)
+					{
+						best_ = n;
+						best_h_ = hval;
+					}
+					#ifndef NDEBUG
+					if(verbose_)
+					{
+						uint32_t x, y;
+						expander_->get_xy(n->get_id(), x, y);
+						std::cerr << "  generating ("<<x<<", "<<y<<")...";
+						n->print(std::cerr);
+						std::cerr << std::endl;
+					}
+					#endif
+					nodes_generated_++;
+				}
+			}
+			#ifndef NDEBUG
+			if(verbose_)
+			{
+				uint32_t x, y;
+				expander_->get_xy(current->get_id(), x, y);
+				std::cerr <<"closing ("<<x<<", "<<y<<")...";
+				current->print(std::cerr);
+				std::cerr << std::endl;
 			}
 			#endif
+		}
+
+		// write the path from the start to @param target into @param path
+		// (see ::get_path). 
+		// @return the cost of the path or warthog::COST_MAX if @param target
+		// is null
+		warthog::cost_t
+		extract_path(warthog::search_node* target,
+				std::vector<warthog::sn_id_t>& path, bool expand_jumps)
+		{
+			path.clear();
+			if(target == 0) { return warthog::COST_MAX; }
+
+			for(warthog::search_node* cur = target;
+					cur != 0;
+				    cur = parent_of(cur))
+			{
+				path.push_back(cur->get_id());
+				warthog::sn_id_t parent_id = cur->get_parent_id();
+				if(!expand_jumps || parent_id == warthog::INF) { continue; }
+
+				// we walk the path backwards so every edge is expanded 
+				// from its end: straight steps first, then diagonal.
+				// NB: ids need not be row-major (see blockmap) so we move 
+				// from tile to tile with the help of the expansion policy
+				uint32_t x, y, px, py;
+				expander_->get_xy(cur->get_id(), x, y);
+				expander_->get_xy(parent_id, px, py);
+				warthog::sn_id_t id = cur->get_id();
+				while(true)
+				{
+					uint32_t dx = x < px ? px - x : x - px;
+					uint32_t dy = y < py ? py - y : y - py;
+					if(dx + dy <= 1 || (dx == 1 && dy == 1)) { break; }
+					int32_t sx = 0, sy = 0;
+					if(dx >= dy) { sx = x < px ? 1 : -1; }
+					if(dy >= dx) { sy = y < py ? 1 : -1; }
+					x += sx;
+					y += sy;
+					id = expander_->get_neighbour_id(id, sx, sy);
+					path.push_back(id);
+				}
 			}
+			std::reverse(path.begin(), path.end());
+			assert(path.front() == instance_.get_start());
+			return target->get_g();
+		}
 
-			mytimer.stop();
-			search_time_ = mytimer.elapsed_time_micro();
-			return goal;
+		// add @param n to the open list with priority @param fval
+		inline void
+		push(warthog::search_node* n, warthog::cost_t fval)
+		{
+#ifdef WARTHOG_COMPACT_NODES
+			open_->push(n, fval);
+#else
+			n->set_f(fval);
+			open_->push(n);
+#endif
+		}
+
+		// compact nodes refer to their parents by id; the expansion policy
+		// maps ids back to (already generated) nodes
+		inline warthog::search_node*
+		parent_of(warthog::search_node* n)
+		{
+#ifdef WARTHOG_COMPACT_NODES
+			warthog::sn_id_t parent_id = n->get_parent_id();
+			if(parent_id == warthog::INF) { return 0; }
+			return expander_->generate(parent_id);
+#else
+			return n->get_parent();
+#endif
 		}
 
 		void
@@ -327,14 +659,13 @@ class flexible_astar
 		{
 			open_->clear();
 			expander_->clear();
+			active_ = false;
+			goal_ = best_ = 0;
 		}
 
 
 };
 
-template <class H, class E>
-uint32_t warthog::flexible_astar<H, E>::searchid_ = 0;
-
 }
 
 #endif
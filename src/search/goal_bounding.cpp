@@ -0,0 +1,182 @@
+#include "first_move_search.h"
+#include "goal_bounding.h"
+#include "gridmap.h"
+#include "timer.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+// the size (in bytes) of a database with @param num_nodes tiles with
+// boxes, for a map of @param mapsize (padded) tiles
+uint64_t
+db_size(uint64_t num_nodes, uint64_t mapsize)
+{
+	return sizeof(int16_t) * warthog::goal_bounding_ns::STRIDE * num_nodes +
+		sizeof(uint32_t) * mapsize;
+}
+
+}
+
+const uint32_t warthog::goal_bounding::NONE;
+
+warthog::goal_bounding::goal_bounding(warthog::gridmap* map,
+		uint32_t nthreads, warthog::jpsplus_preproc::progress_fn progress)
+	: map_(map), width_(map->width()), mapsize_(map->padded_mapsize()),
+	num_nodes_(0), preproc_time_(0),
+	file_(map, ".gb", warthog::mapped_db_ns::GOAL_BOUNDS,
+		warthog::goal_bounding_ns::VERSION, "goal bounds"),
+	boxes_(0), rank_(0)
+{
+	if(load()) { return; }
+
+	if(nthreads == 0) { nthreads = warthog::jpsplus_preproc::default_threads(); }
+	warthog::timer mytimer;
+	mytimer.start();
+	compute(nthreads, progress);
+	mytimer.stop();
+	preproc_time_ = mytimer.elapsed_time_micro();
+	std::cerr << "goal bounds computed in "
+		<< preproc_time_ / 1e6 << "s using " << nthreads << " thread(s); "
+		<< num_nodes_ << " nodes\n";
+
+	save();
+}
+
+warthog::goal_bounding::~goal_bounding()
+{
+}
+
+bool
+warthog::goal_bounding::load()
+{
+	// the header holds the number of tiles with boxes
+	uint64_t mapsize = mapsize_;
+	if(!file_.load([mapsize](const uint64_t* params) {
+				return params[0] > mapsize ?
+					warthog::mapped_db_ns::UNSUITABLE :
+					db_size(params[0], mapsize); }))
+	{
+		return false;
+	}
+
+	num_nodes_ = file_.params()[0];
+	boxes_ = (const int16_t*)file_.payload();
+	rank_ = (const uint32_t*)(boxes_ +
+			warthog::goal_bounding_ns::STRIDE * (size_t)num_nodes_);
+	return true;
+}
+
+void
+warthog::goal_bounding::compute(uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn& progress)
+{
+	if(map_->width() > warthog::goal_bounding_ns::MAX_DIM ||
+			map_->height() > warthog::goal_bounding_ns::MAX_DIM)
+	{
+		std::cerr << "err; map too large for goal bounding. aborting\n";
+		exit(1);
+	}
+
+	std::vector<uint8_t> moves = warthog::first_move_ns::legal_moves(map_);
+	heap_rank_.assign(mapsize_, NONE);
+	std::vector<uint32_t> order;
+	for(uint32_t id = 0; id < mapsize_; id++)
+	{
+		if(!map_->get_label(id)) { continue; }
+		heap_rank_[id] = order.size();
+		order.push_back(id);
+	}
+	num_nodes_ = order.size();
+
+	// every box starts out empty
+	const uint32_t stride = warthog::goal_bounding_ns::STRIDE;
+	heap_boxes_.resize((size_t)stride * num_nodes_);
+	for(uint32_t i = 0; i < num_nodes_; i++)
+	{
+		int16_t* b = &heap_boxes_[(size_t)i * stride];
+		for(uint32_t m = 0; m < 8; m++)
+		{
+			b[m] = b[m+16] = warthog::goal_bounding_ns::MAX_DIM;
+			b[m+8] = b[m+24] = -1;
+		}
+	}
+
+	// each thread claims the next source, runs a search and grows the
+	// box of every optimal first move to every tile reached. the boxes
+	// of a source are written only by the thread that claimed it.
+	std::atomic<uint32_t> next(0);
+	std::atomic<uint32_t> done(0);
+	std::thread::id owner = std::this_thread::get_id();
+	uint32_t last_report = 0;
+	std::function<void()> work = [&]() {
+		warthog::first_move_search search(moves, width_);
+		for(uint32_t src = next.fetch_add(1); src < num_nodes_;
+				src = next.fetch_add(1))
+		{
+			search.run(order[src]);
+			int16_t* b = &heap_boxes_[(size_t)src * stride];
+			const std::vector<uint32_t>& reached = search.get_reached();
+			for(uint32_t i = 1; i < reached.size(); i++)
+			{
+				int16_t x = reached[i] % width_;
+				int16_t y = reached[i] / width_;
+				for(uint32_t first = search.get_first_moves(reached[i]);
+						first; first &= first - 1)
+				{
+					uint32_t m = __builtin_ctz(first);
+					if(x < b[m]) { b[m] = x; }
+					if(x > b[m+8]) { b[m+8] = x; }
+					if(y < b[m+16]) { b[m+16] = y; }
+					if(y > b[m+24]) { b[m+24] = y; }
+				}
+			}
+
+			uint32_t finished = done.fetch_add(1) + 1;
+			if(progress && std::this_thread::get_id() == owner &&
+					(uint64_t)(finished - last_report)*100 >= num_nodes_)
+			{
+				progress(finished, num_nodes_);
+				last_report = finished;
+			}
+		}
+	};
+
+	std::vector<std::thread*> threads;
+	for(uint32_t i = 1; i < nthreads && i < num_nodes_; i++)
+	{
+		threads.push_back(new std::thread(work));
+	}
+	work();
+	for(uint32_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->join();
+		delete threads[i];
+	}
+	if(progress) { progress(num_nodes_, num_nodes_); }
+
+	boxes_ = heap_boxes_.size() ? &heap_boxes_[0] : 0;
+	rank_ = &heap_rank_[0];
+}
+
+bool
+warthog::goal_bounding::save()
+{
+	uint64_t params[warthog::mapped_db_ns::NUM_PARAMS] = { num_nodes_ };
+	warthog::mapped_db_ns::block blocks[2] = {
+		{ boxes_, sizeof(int16_t) * warthog::goal_bounding_ns::STRIDE *
+			(size_t)num_nodes_ },
+		{ rank_, sizeof(uint32_t) * mapsize_ } };
+	return file_.save(params, blocks, 2);
+}
+
+size_t
+warthog::goal_bounding::mem()
+{
+	return sizeof(*this) + db_size(num_nodes_, mapsize_);
+}
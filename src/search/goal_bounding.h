@@ -0,0 +1,166 @@
+#ifndef WARTHOG_GOAL_BOUNDING_H
+#define WARTHOG_GOAL_BOUNDING_H
+
+// goal_bounding.h
+//
+// Goal bounding for uniform-cost grid maps. For every traversable tile n
+// and every move m out of n, the database stores the smallest axis-aligned
+// box that contains every tile t such that some optimal path from n to t
+// begins with m. During search, a successor of n reached by m can be
+// skipped whenever the goal lies outside the box of (n, m): no optimal
+// path to the goal continues that way. The boxes are used by the grid and
+// jps+ expansion policies (see ::set_goal_bounding on each) and apply to
+// jump points as well, since every jump begins with a single move.
+//
+// The boxes of each source are found with a warthog::first_move_search.
+// Preprocessing time is quadratic in the number of traversable tiles (as
+// for warthog::cpd) and the searches run in parallel; the boxes are then
+// stored next to the map, in a file with the suffix .gb, and mapped
+// read-only into memory (mmap) when loaded. The file has the format of
+// warthog::mapped_db: a header that is checked against the current map,
+// then the boxes of every tile, numbered in order of padded id, then the
+// number of every tile (by padded id; NONE for obstacles).
+//
+// Boxes are stored in (padded) map coordinates, 16 bits each: the eight
+// boxes of a tile fill one cache line of 64 bytes, laid out as the lower
+// x bounds of all moves, then the upper x bounds, the lower y bounds and
+// the upper y bounds. All eight are tested at once with SSE2 instructions.
+// A move that begins no optimal path has an empty box.
+//
+// Theoretical details:
+// [Rabin S. and Sturtevant N., 2016, Combining Bounding Boxes and JPS to
+// Prune Grid Pathfinding, AAAI]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "constants.h"
+#include "gridmap.h"
+#include "jpsplus_preproc.h"
+#include "mapped_db.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace warthog
+{
+
+namespace goal_bounding_ns
+{
+	static const uint32_t VERSION = 1;
+
+	// 16 bit values per tile: 4 bounds for each of 8 moves
+	static const uint32_t STRIDE = 32;
+
+	// coordinates are signed 16 bit values (see ::moves_toward)
+	static const uint32_t MAX_DIM = 0x7fff;
+}
+
+class goal_bounding
+{
+	public:
+		// no such tile (an obstacle)
+		static const uint32_t NONE = 0xffffffff;
+
+		// the boxes are loaded from disk or, if no valid copy exists,
+		// computed using @param nthreads threads (0 = one per core) and
+		// saved. @param progress, if given, is called as preprocessing
+		// advances.
+		goal_bounding(warthog::gridmap* map, uint32_t nthreads = 0,
+				warthog::jpsplus_preproc::progress_fn progress =
+				warthog::jpsplus_preproc::progress_fn());
+		~goal_bounding();
+
+		// @return the moves out of the tile with (padded) id @param id
+		// which begin some optimal path toward the tile with (padded) id
+		// @param goalid (bit i = move i, in the order of
+		// warthog::jps::direction). every move is allowed if either tile
+		// is out of range or an obstacle.
+		inline uint32_t
+		moves_toward(warthog::sn_id_t id, warthog::sn_id_t goalid)
+		{
+			if(id >= mapsize_ || goalid >= mapsize_) { return 0xff; }
+			uint32_t r = rank_[id];
+			if(r == NONE) { return 0xff; }
+			const int16_t* b = boxes_ + (size_t)r * warthog::goal_bounding_ns::STRIDE;
+			int16_t gx = goalid % width_;
+			int16_t gy = goalid / width_;
+#ifdef __SSE2__
+			__m128i x = _mm_set1_epi16(gx);
+			__m128i y = _mm_set1_epi16(gy);
+			__m128i out = _mm_or_si128(
+				_mm_or_si128(
+					_mm_cmplt_epi16(x, _mm_loadu_si128((const __m128i*)(b))),
+					_mm_cmpgt_epi16(x, _mm_loadu_si128((const __m128i*)(b+8)))),
+				_mm_or_si128(
+					_mm_cmplt_epi16(y, _mm_loadu_si128((const __m128i*)(b+16))),
+					_mm_cmpgt_epi16(y, _mm_loadu_si128((const __m128i*)(b+24)))));
+			return ~_mm_movemask_epi8(_mm_packs_epi16(out, out)) & 0xff;
+#else
+			uint32_t moves = 0;
+			for(uint32_t m = 0; m < 8; m++)
+			{
+				if(gx >= b[m] && gx <= b[m+8] && gy >= b[m+16] && gy <= b[m+24])
+				{
+					moves |= (1 << m);
+				}
+			}
+			return moves;
+#endif
+		}
+
+		// number of tiles with boxes
+		inline uint32_t
+		num_nodes() { return num_nodes_; }
+
+		// time (in microseconds) spent computing the boxes;
+		// zero if they were loaded from disk
+		inline double
+		get_preproc_time() { return preproc_time_; }
+
+		inline const char*
+		filename() { return file_.filename(); }
+
+		size_t
+		mem();
+
+	private:
+		warthog::gridmap* map_;
+		uint32_t width_;
+		uint32_t mapsize_;
+		uint32_t num_nodes_;
+		double preproc_time_;
+
+		// the database, in a mapped file or in the vectors below
+		warthog::mapped_db file_;
+		const int16_t* boxes_;
+		const uint32_t* rank_;
+		std::vector<int16_t> heap_boxes_;
+		std::vector<uint32_t> heap_rank_;
+
+		bool
+		load();
+
+		void
+		compute(uint32_t nthreads,
+				warthog::jpsplus_preproc::progress_fn& progress);
+
+		bool
+		save();
+
+		// no copy
+		goal_bounding(const goal_bounding& other)
+			: file_(0, "", 0, 0, "") { }
+		goal_bounding&
+		operator=(const goal_bounding& other) { return *this; }
+};
+
+}
+
+#endif
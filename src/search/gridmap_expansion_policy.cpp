@@ -1,21 +1,26 @@
 #include "blocklist.h"
+#include "goal_bounding.h"
 #include "gridmap_expansion_policy.h"
 #include "helpers.h"
+#include "jps.h"
 #include "problem_instance.h"
 
-warthog::gridmap_expansion_policy::gridmap_expansion_policy(
-		warthog::gridmap* map) : map_(map)
+template <class P, class M>
+warthog::gridmap_expansion_policy_t<P, M>::gridmap_expansion_policy_t(
+		M* map) : map_(map), bounds_(0)
 {
-	nodepool_ = new warthog::blocklist(map->height(), map->width());
+	nodepool_ = new P(map->height(), map->width());
 }
 
-warthog::gridmap_expansion_policy::~gridmap_expansion_policy()
+template <class P, class M>
+warthog::gridmap_expansion_policy_t<P, M>::~gridmap_expansion_policy_t()
 {
 	delete nodepool_;
 }
 
+template <class P, class M>
 void 
-warthog::gridmap_expansion_policy::expand(warthog::search_node* current,
+warthog::gridmap_expansion_policy_t<P, M>::expand(warthog::search_node* current,
 		warthog::problem_instance* problem)
 {
 	reset();
@@ -40,63 +45,80 @@ warthog::gridmap_expansion_policy::expand(warthog::search_node* current,
 //	#endif
 
 	// NB: no corner cutting or squeezing between obstacles!
-	uint32_t nid_m_w = nodeid - map_->width();
-	uint32_t nid_p_w = nodeid + map_->width();
+	uint32_t nid_m_w = map_->get_neighbour_id(nodeid, 0, -1);
+	uint32_t nid_p_w = map_->get_neighbour_id(nodeid, 0, 1);
 
-	if((tiles & 514) == 514) // N
+	// moves that begin some optimal path to the goal
+	uint32_t dirs = bounds_ ?
+		bounds_->moves_toward(nodeid, problem->get_goal()) : 0xff;
+
+	if((tiles & 514) == 514 && (dirs & warthog::jps::NORTH)) // N
 	{  
 		neis_[num_neis_] = nodepool_->generate(nid_m_w);
 		costs_[num_neis_] = warthog::ONE;
 		num_neis_++;
 	} 
 
-	if((tiles & 1542) == 1542) // NE
+	if((tiles & 1542) == 1542 && (dirs & warthog::jps::NORTHEAST)) // NE
 	{ 
-		neis_[num_neis_] = nodepool_->generate(nid_m_w + 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nid_m_w, 1, 0));
 		costs_[num_neis_] = warthog::ROOT_TWO;
 		num_neis_++;
 	}
 
-	if((tiles & 1536) == 1536) // E
+	if((tiles & 1536) == 1536 && (dirs & warthog::jps::EAST)) // E
 	{
-		neis_[num_neis_] = nodepool_->generate(nodeid + 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nodeid, 1, 0));
 		costs_[num_neis_] = warthog::ONE;
 		num_neis_++;
 	}
 	
-	if((tiles & 394752) == 394752) // SE
+	if((tiles & 394752) == 394752 && (dirs & warthog::jps::SOUTHEAST)) // SE
 	{	
-		neis_[num_neis_] = nodepool_->generate(nid_p_w + 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nid_p_w, 1, 0));
 		costs_[num_neis_] = warthog::ROOT_TWO;
 		num_neis_++;
 	}
 
-	if((tiles & 131584) == 131584) // S
+	if((tiles & 131584) == 131584 && (dirs & warthog::jps::SOUTH)) // S
 	{ 
 		neis_[num_neis_] = nodepool_->generate(nid_p_w);
 		costs_[num_neis_] = warthog::ONE;
 		num_neis_++;
 	}
 
-	if((tiles & 197376) == 197376) // SW
+	if((tiles & 197376) == 197376 && (dirs & warthog::jps::SOUTHWEST)) // SW
 	{ 
-		neis_[num_neis_] = nodepool_->generate(nid_p_w - 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nid_p_w, -1, 0));
 		costs_[num_neis_] = warthog::ROOT_TWO;
 		num_neis_++;
 	}
 
-	if((tiles & 768) == 768) // W
+	if((tiles & 768) == 768 && (dirs & warthog::jps::WEST)) // W
 	{ 
-		neis_[num_neis_] = nodepool_->generate(nodeid - 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nodeid, -1, 0));
 		costs_[num_neis_] = warthog::ONE;
 		num_neis_++;
 	}
 
-	if((tiles & 771) == 771) // NW
+	if((tiles & 771) == 771 && (dirs & warthog::jps::NORTHWEST)) // NW
 	{ 
-		neis_[num_neis_] = nodepool_->generate(nid_m_w - 1);
+		neis_[num_neis_] = nodepool_->generate(
+				map_->get_neighbour_id(nid_m_w, -1, 0));
 		costs_[num_neis_] = warthog::ROOT_TWO;
 		num_neis_++;
 	}
 }
 
+// the available node pools and maps
+template class warthog::gridmap_expansion_policy_t<warthog::blocklist>;
+template class warthog::gridmap_expansion_policy_t<warthog::flat_nodepool>;
+template class warthog::gridmap_expansion_policy_t<
+	warthog::blocklist, warthog::blockmap>;
+template class warthog::gridmap_expansion_policy_t<
+	warthog::flat_nodepool, warthog::blockmap>;
@@ -5,25 +5,45 @@
 //
 // An ExpansionPolicy for square uniform-cost grids 
 //
+// The policy is parameterised by its node pool, P. Two variants are 
+// provided: warthog::gridmap_expansion_policy allocates nodes on demand 
+// (warthog::blocklist) and warthog::flat_gridmap_expansion_policy keeps
+// one node for every tile (warthog::flat_nodepool).
+//
+// It is also parameterised by the type of map, M: warthog::gridmap 
+// (row-major) or warthog::blockmap (cache-line sized blocks of tiles; 
+// better locality on very large maps). The blockmap variants are 
+// warthog::blockmap_expansion_policy and 
+// warthog::flat_blockmap_expansion_policy. Goal bounding (see
+// ::set_goal_bounding) needs warthog::gridmap ids and does not compile
+// with a blockmap.
+//
 // @author: dharabor
 // @created: 28/10/2010
 //
 
 #include "blocklist.h"
+#include "blockmap.h"
+#include "flat_nodepool.h"
 #include "gridmap.h"
 #include "search_node.h"
 
 #include <memory>
+#include <type_traits>
 
 namespace warthog
 {
 
+class goal_bounding;
 class problem_instance;
-class gridmap_expansion_policy 
+
+// P is a node pool; M is a map
+template <class P, class M = warthog::gridmap>
+class gridmap_expansion_policy_t
 {
 	public:
-		gridmap_expansion_policy(warthog::gridmap* map);
-		~gridmap_expansion_policy();
+		gridmap_expansion_policy_t(M* map);
+		~gridmap_expansion_policy_t();
 
 		warthog::search_node*
 		generate(uint32_t node_id)
@@ -33,6 +53,28 @@ class gridmap_expansion_policy
 			return n;
 		}
 
+		// @return the node with the given id or null if it has not been
+		// generated since the last call to ::clear
+		inline warthog::search_node*
+		find(warthog::sn_id_t node_id)
+		{
+			return nodepool_->find(node_id);
+		}
+
+		// skip every neighbour whose goal bounding box excludes the goal
+		// (see warthog::goal_bounding). @param bounds is not owned by this
+		// policy; null (the default) disables pruning.
+		// NB: a member template, so that the check below applies only 
+		// when the method is used (not on explicit instantiation)
+		template<class M2 = M>
+		inline void
+		set_goal_bounding(warthog::goal_bounding* bounds) 
+		{ 
+			static_assert(std::is_same<M2, warthog::gridmap>::value,
+					"goal bounding needs the ids of warthog::gridmap");
+			bounds_ = bounds; 
+		}
+
 		inline void
 		clear()
 		{
@@ -49,7 +91,7 @@ class gridmap_expansion_policy
 			for(int i=0; i < 10; i++)
 			{
 				neis_[i] = 0;
-				costs_[i] = warthog::INF;
+				costs_[i] = warthog::COST_MAX;
 			}
 		}
 
@@ -112,10 +154,26 @@ class gridmap_expansion_policy
 		{
 			return map_->width();
 		}
+
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
 	
 	private:
-		warthog::gridmap* map_;
-		warthog::blocklist* nodepool_;
+		M* map_;
+		P* nodepool_;
+		warthog::goal_bounding* bounds_;
 
 		// 3x3 square of tiles + one terminal element
 		warthog::search_node* neis_[10]; 
@@ -124,6 +182,15 @@ class gridmap_expansion_policy
 		uint32_t num_neis_; // might have < 9 (some could be blocked)
 };
 
+typedef gridmap_expansion_policy_t<warthog::blocklist> 
+	gridmap_expansion_policy;
+typedef gridmap_expansion_policy_t<warthog::flat_nodepool> 
+	flat_gridmap_expansion_policy;
+typedef gridmap_expansion_policy_t<warthog::blocklist, warthog::blockmap>
+	blockmap_expansion_policy;
+typedef gridmap_expansion_policy_t<warthog::flat_nodepool, warthog::blockmap>
+	flat_blockmap_expansion_policy;
+
 }
 
 #endif
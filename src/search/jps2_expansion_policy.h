@@ -96,6 +96,21 @@ class jps2_expansion_policy
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::gridmap* map_;
 		warthog::blocklist* nodepool_;
@@ -105,6 +120,7 @@ class jps2_expansion_policy
 		std::vector<warthog::search_node*> neighbours_;
 		std::vector<warthog::cost_t> costs_;
 		std::vector<uint32_t> jp_ids_;
+		std::vector<warthog::jps::direction> jp_dirs_;
 
 		inline void
 		reset()
@@ -114,6 +130,7 @@ class jps2_expansion_policy
 			neighbours_.clear();
 			costs_.clear();
 			jp_ids_.clear();
+			jp_dirs_.clear();
 		}
 
 };
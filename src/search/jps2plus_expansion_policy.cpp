@@ -3,13 +3,18 @@
 warthog::jps2plus_expansion_policy::jps2plus_expansion_policy(warthog::gridmap* map)
 {
 	map_ = map;
+#ifdef WARTHOG_COMPACT_NODES
+	nodepool_ = new warthog::blocklist(map->height(), map->width());
+#else
 	nodepool_ = new warthog::blocklist2(map->height(), map->width());
+#endif
 	jpl_ = new warthog::offline_jump_point_locator2(map);
 	reset();
 
 	neighbours_.reserve(100);
 	costs_.reserve(100);
 	jp_ids_.reserve(100);
+	jp_dirs_.reserve(100);
 }
 
 warthog::jps2plus_expansion_policy::~jps2plus_expansion_policy()
@@ -42,22 +47,22 @@ warthog::jps2plus_expansion_policy::expand(
 		warthog::jps::direction d = (warthog::jps::direction) (1 << i);
 		if(succ_dirs & d)
 		{
-			jpl_->jump(d, current_id, goal_id, jp_ids_, costs_);
+			jpl_->jump(d, current_id, goal_id, jp_ids_, jp_dirs_, costs_);
 		}
 	}
 
+#ifndef WARTHOG_COMPACT_NODES
 	uint32_t searchid = problem->get_searchid();
-	uint32_t id_mask = (1 << 24)-1;
+#endif
 	for(uint32_t i = 0; i < jp_ids_.size(); i++)
 	{
-		// bits 0-23 store the id of the jump point
-		// bits 24-31 store the direction to the parent
-		uint32_t jp_id = jp_ids_.at(i);
-		warthog::jps::direction pdir = (warthog::jps::direction)*(((uint8_t*)(&jp_id))+3);
-
-		warthog::search_node* mynode = nodepool_->generate(jp_id & id_mask);
+		// jp_dirs_[i] is the direction of travel to jump point jp_ids_[i]
+		warthog::jps::direction pdir = jp_dirs_.at(i);
+		warthog::search_node* mynode = nodepool_->generate(jp_ids_.at(i));
 		neighbours_.push_back(mynode);
+#ifndef WARTHOG_COMPACT_NODES
 		if(mynode->get_searchid() != searchid) { mynode->reset(searchid); }
+#endif
 
 		// stupid hack
 		if((current->get_g() + costs_.at(i)) < mynode->get_g())
@@ -9,6 +9,7 @@
 // @author: dharabor
 // @created: 06/01/2010
 
+#include "blocklist.h"
 #include "blocklist2.h"
 #include "gridmap.h"
 #include "helpers.h"
@@ -94,15 +95,37 @@ class jps2plus_expansion_policy
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::gridmap* map_;
+#ifdef WARTHOG_COMPACT_NODES
+		// compact nodes have no searchid and cannot be reset lazily;
+		// use a pool that discards all nodes after each search instead
+		warthog::blocklist* nodepool_;
+#else
 		warthog::blocklist2* nodepool_;
+#endif
 		offline_jump_point_locator2* jpl_;
 		uint32_t which_;
 		uint32_t num_neighbours_;
 		std::vector<warthog::search_node*> neighbours_;
 		std::vector<warthog::cost_t> costs_;
 		std::vector<uint32_t> jp_ids_;
+		std::vector<warthog::jps::direction> jp_dirs_;
 
 		inline void
 		reset()
@@ -112,6 +135,7 @@ class jps2plus_expansion_policy
 			neighbours_.clear();
 			costs_.clear();
 			jp_ids_.clear();
+			jp_dirs_.clear();
 		}
 
 };
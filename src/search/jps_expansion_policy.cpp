@@ -1,28 +1,44 @@
 #include "jps_expansion_policy.h"
 
-warthog::jps_expansion_policy::jps_expansion_policy(warthog::gridmap* map)
+template <class P>
+warthog::jps_expansion_policy_t<P>::jps_expansion_policy_t(warthog::gridmap* map)
 {
 	map_ = map;
-	nodepool_ = new warthog::blocklist(map->height(), map->width());
+	nodepool_ = new P(map->height(), map->width());
 	jpl_ = new warthog::online_jump_point_locator(map);
+	owns_jpl_ = true;
 	reset();
 }
 
-warthog::jps_expansion_policy::~jps_expansion_policy()
+template <class P>
+warthog::jps_expansion_policy_t<P>::jps_expansion_policy_t(warthog::gridmap* map,
+		warthog::online_jump_point_locator* jpl)
 {
-	delete jpl_;
+	map_ = map;
+	nodepool_ = new P(map->height(), map->width());
+	jpl_ = jpl;
+	owns_jpl_ = false;
+	reset();
+}
+
+template <class P>
+warthog::jps_expansion_policy_t<P>::~jps_expansion_policy_t()
+{
+	if(owns_jpl_) { delete jpl_; }
 	delete nodepool_;
 }
 
+template <class P>
 void 
-warthog::jps_expansion_policy::expand(
+warthog::jps_expansion_policy_t<P>::expand(
 		warthog::search_node* current, warthog::problem_instance* problem)
 {
 	reset();
 
 	// compute the direction of travel used to reach the current node.
 	warthog::jps::direction dir_c =
-	   	this->compute_direction(current->get_parent(), current);
+	   	this->compute_direction(
+			current->get_parent_id(), current->get_id());
 
 	// get the tiles around the current node c
 	uint32_t c_tiles;
@@ -53,3 +69,6 @@ warthog::jps_expansion_policy::expand(
 	}
 }
 
+// the available node pools
+template class warthog::jps_expansion_policy_t<warthog::blocklist>;
+template class warthog::jps_expansion_policy_t<warthog::flat_nodepool>;
@@ -15,10 +15,16 @@
 // [Harabor D. and Grastien A., 2011, Online Node Pruning for Pathfinding
 // On Grid Maps, AAAI] 
 //
+// The policy is parameterised by its node pool, P. Two variants are 
+// provided: warthog::jps_expansion_policy allocates nodes on demand 
+// (warthog::blocklist) and warthog::flat_jps_expansion_policy keeps
+// one node for every tile (warthog::flat_nodepool).
+//
 // @author: dharabor
 // @created: 06/01/2010
 
 #include "blocklist.h"
+#include "flat_nodepool.h"
 #include "gridmap.h"
 #include "helpers.h"
 #include "jps.h"
@@ -31,11 +37,19 @@
 namespace warthog
 {
 
-class jps_expansion_policy 
+// P is a node pool
+template <class P>
+class jps_expansion_policy_t
 {
 	public:
-		jps_expansion_policy(warthog::gridmap* map);
-		~jps_expansion_policy();
+		jps_expansion_policy_t(warthog::gridmap* map);
+
+		// as above, but jump points are found using the shared locator
+		// @param jpl. the locator is not owned by this policy and a single
+		// instance can serve several policies (and threads) at once.
+		jps_expansion_policy_t(warthog::gridmap* map, 
+				warthog::online_jump_point_locator* jpl);
+		~jps_expansion_policy_t();
 
 		// create a warthog::search_node object from a state description
 		// (in this case, an id)
@@ -103,10 +117,26 @@ class jps_expansion_policy
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::gridmap* map_;
-		warthog::blocklist* nodepool_;
+		P* nodepool_;
 		warthog::online_jump_point_locator* jpl_;
+		bool owns_jpl_;
 		uint32_t which_;
 		uint32_t num_neighbours_;
 		warthog::search_node* neighbours_[9];
@@ -115,13 +145,13 @@ class jps_expansion_policy
 		// computes the direction of travel; from a node n1
 		// to a node n2.
 		inline warthog::jps::direction
-		compute_direction(warthog::search_node* n1, warthog::search_node* n2)
+		compute_direction(uint32_t n1_id, uint32_t n2_id)
 		{
-			if(n1 == 0) { return warthog::jps::NONE; }
+			if(n1_id == warthog::INF) { return warthog::jps::NONE; }
 
 			uint32_t x, y, x2, y2;
-			warthog::helpers::index_to_xy(n1->get_id(), map_->width(), x, y);
-			warthog::helpers::index_to_xy(n2->get_id(), map_->width(), x2, y2);
+			warthog::helpers::index_to_xy(n1_id, map_->width(), x, y);
+			warthog::helpers::index_to_xy(n2_id, map_->width(), x2, y2);
 			warthog::jps::direction dir = warthog::jps::NONE;
 			if(y2 == y)
 			{
@@ -162,6 +192,10 @@ class jps_expansion_policy
 
 };
 
+typedef jps_expansion_policy_t<warthog::blocklist> jps_expansion_policy;
+typedef jps_expansion_policy_t<warthog::flat_nodepool> 
+	flat_jps_expansion_policy;
+
 }
 
 #endif
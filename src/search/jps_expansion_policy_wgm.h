@@ -100,6 +100,21 @@ class jps_expansion_policy_wgm
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::weighted_gridmap* map_;
 		warthog::blocklist* nodepool_;
@@ -112,13 +127,13 @@ class jps_expansion_policy_wgm
 		// computes the direction of travel; from a node n1
 		// to a node n2.
 		inline warthog::jps::direction
-		compute_direction(warthog::search_node* n1, warthog::search_node* n2)
+		compute_direction(uint32_t n1_id, uint32_t n2_id)
 		{
-			if(n1 == 0) { return warthog::jps::NONE; }
+			if(n1_id == warthog::INF) { return warthog::jps::NONE; }
 
 			uint32_t x, y, x2, y2;
-			warthog::helpers::index_to_xy(n1->get_id(), map_->width(), x, y);
-			warthog::helpers::index_to_xy(n2->get_id(), map_->width(), x2, y2);
+			warthog::helpers::index_to_xy(n1_id, map_->width(), x, y);
+			warthog::helpers::index_to_xy(n2_id, map_->width(), x2, y2);
 			warthog::jps::direction dir = warthog::jps::NONE;
 			if(y2 == y)
 			{
@@ -0,0 +1,68 @@
+#include "gridmap.h"
+#include "jpsplus_db.h"
+
+warthog::jpsplus_db::jpsplus_db(warthog::gridmap* map, uint32_t kind)
+	: map_(map),
+	file_(map,
+		(kind == warthog::jpsplus_db_ns::JPS2PLUS) ? ".jps2+" : ".jps+",
+		kind, warthog::jpsplus_db_ns::VERSION, "jump-point graph"),
+	dbsize_(0), labels_(0), heap_labels_(0)
+{
+}
+
+warthog::jpsplus_db::~jpsplus_db()
+{
+	release();
+}
+
+void
+warthog::jpsplus_db::release()
+{
+	file_.release();
+	delete [] heap_labels_;
+	heap_labels_ = 0;
+	labels_ = 0;
+	dbsize_ = 0;
+}
+
+bool
+warthog::jpsplus_db::load()
+{
+	release();
+	uint64_t dbsize = 8*(uint64_t)map_->padded_mapsize();
+	if(!file_.load([dbsize](const uint64_t*) {
+				return sizeof(uint16_t)*dbsize; }))
+	{
+		return false;
+	}
+	dbsize_ = dbsize;
+	labels_ = (const uint16_t*)file_.payload();
+	return true;
+}
+
+uint16_t*
+warthog::jpsplus_db::create()
+{
+	release();
+	dbsize_ = 8*(uint64_t)map_->padded_mapsize();
+	heap_labels_ = new uint16_t[dbsize_];
+	for(uint64_t i=0; i < dbsize_; i++) heap_labels_[i] = 0;
+	labels_ = heap_labels_;
+	return heap_labels_;
+}
+
+bool
+warthog::jpsplus_db::save()
+{
+	if(heap_labels_ == 0) { return false; }
+
+	warthog::mapped_db_ns::block labels =
+		{ heap_labels_, sizeof(uint16_t)*(size_t)dbsize_ };
+	return file_.save(0, &labels, 1);
+}
+
+size_t
+warthog::jpsplus_db::mem()
+{
+	return sizeof(*this) + sizeof(uint16_t)*(size_t)dbsize_;
+}
@@ -0,0 +1,89 @@
+#ifndef WARTHOG_JPSPLUS_DB_H
+#define WARTHOG_JPSPLUS_DB_H
+
+// jpsplus_db.h
+//
+// On-disk storage for the jump labels computed by
+// warthog::offline_jump_point_locator and
+// warthog::offline_jump_point_locator2 (8 labels of 16 bits per node).
+//
+// The file format (a header that is checked against the current map,
+// memory-mapped loading and atomic replacement) is that of
+// warthog::mapped_db; the payload is the array of labels.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "gridmap.h"
+#include "mapped_db.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace warthog
+{
+
+namespace jpsplus_db_ns
+{
+	static const uint32_t VERSION = 2;
+
+	// identifies the locator that produced the labels
+	static const uint32_t JPSPLUS = warthog::mapped_db_ns::JPSPLUS;
+	static const uint32_t JPS2PLUS = warthog::mapped_db_ns::JPS2PLUS;
+}
+
+class jpsplus_db
+{
+	public:
+		// @param kind: one of the constants in warthog::jpsplus_db_ns
+		jpsplus_db(warthog::gridmap* map, uint32_t kind);
+		~jpsplus_db();
+
+		// map the database file associated with the current map.
+		// @return false if the file does not exist or if it is stale.
+		bool
+		load();
+
+		// allocate (zero-initialised) labels for a new database.
+		// the caller fills in the labels and then calls ::save
+		uint16_t*
+		create();
+
+		// write the labels returned by ::create to disk
+		bool
+		save();
+
+		inline const uint16_t*
+		labels() { return labels_; }
+
+		inline uint64_t
+		size() { return dbsize_; }
+
+		inline const char*
+		filename() { return file_.filename(); }
+
+		size_t
+		mem();
+
+	private:
+		warthog::gridmap* map_;
+		warthog::mapped_db file_;
+
+		uint64_t dbsize_;
+		const uint16_t* labels_;
+		uint16_t* heap_labels_;
+
+		void
+		release();
+
+		// no copy
+		jpsplus_db(const jpsplus_db& other)
+			: file_(0, "", 0, 0, "") { }
+		jpsplus_db&
+		operator=(const jpsplus_db& other) { return *this; }
+};
+
+}
+
+#endif
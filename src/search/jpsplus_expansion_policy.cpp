@@ -1,3 +1,4 @@
+#include "goal_bounding.h"
 #include "jpsplus_expansion_policy.h"
 
 warthog::jpsplus_expansion_policy::jpsplus_expansion_policy(warthog::gridmap* map)
@@ -5,12 +6,25 @@ warthog::jpsplus_expansion_policy::jpsplus_expansion_policy(warthog::gridmap* ma
 	map_ = map;
 	nodepool_ = new warthog::blocklist(map->height(), map->width());
 	jpl_ = new warthog::offline_jump_point_locator(map);
+	owns_jpl_ = true;
+	bounds_ = 0;
+	reset();
+}
+
+warthog::jpsplus_expansion_policy::jpsplus_expansion_policy(warthog::gridmap* map,
+		warthog::offline_jump_point_locator* jpl)
+{
+	map_ = map;
+	nodepool_ = new warthog::blocklist(map->height(), map->width());
+	jpl_ = jpl;
+	owns_jpl_ = false;
+	bounds_ = 0;
 	reset();
 }
 
 warthog::jpsplus_expansion_policy::~jpsplus_expansion_policy()
 {
-	delete jpl_;
+	if(owns_jpl_) { delete jpl_; }
 	delete nodepool_;
 }
 
@@ -22,7 +36,8 @@ warthog::jpsplus_expansion_policy::expand(
 
 	// compute the direction of travel used to reach the current node.
 	warthog::jps::direction dir_c =
-	   	this->compute_direction(current->get_parent(), current);
+	   	this->compute_direction(
+			current->get_parent_id(), current->get_id());
 
 	// get the tiles around the current node c
 	uint32_t c_tiles;
@@ -33,6 +48,7 @@ warthog::jpsplus_expansion_policy::expand(
 	// and forced neighbour
 	uint32_t succ_dirs = warthog::jps::compute_successors(dir_c, c_tiles);
 	uint32_t goal_id = problem->get_goal();
+	if(bounds_) { succ_dirs &= bounds_->moves_toward(current_id, goal_id); }
 	for(uint32_t i = 0; i < 8; i++)
 	{
 		warthog::jps::direction d = (warthog::jps::direction) (1 << i);
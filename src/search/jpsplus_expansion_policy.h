@@ -25,12 +25,25 @@
 namespace warthog
 {
 
+class goal_bounding;
 class jpsplus_expansion_policy 
 {
 	public:
 		jpsplus_expansion_policy(warthog::gridmap* map);
+
+		// as above, but jump points are found using the shared locator
+		// @param jpl. the locator is not owned by this policy and a single
+		// instance can serve several policies (and threads) at once.
+		jpsplus_expansion_policy(warthog::gridmap* map, 
+				warthog::offline_jump_point_locator* jpl);
 		~jpsplus_expansion_policy();
 
+		// skip every jump whose goal bounding box excludes the goal (see
+		// warthog::goal_bounding). @param bounds is not owned by this
+		// policy; null (the default) disables pruning.
+		inline void
+		set_goal_bounding(warthog::goal_bounding* bounds) { bounds_ = bounds; }
+
 		// create a warthog::search_node object from a state description
 		// (in this case, an id)
 		inline warthog::search_node*
@@ -97,10 +110,27 @@ class jpsplus_expansion_policy
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::gridmap* map_;
 		warthog::blocklist* nodepool_;
 		offline_jump_point_locator* jpl_;
+		bool owns_jpl_;
+		warthog::goal_bounding* bounds_;
 		uint32_t which_;
 		uint32_t num_neighbours_;
 		warthog::search_node* neighbours_[9];
@@ -109,13 +139,13 @@ class jpsplus_expansion_policy
 		// computes the direction of travel; from a node n1
 		// to a node n2.
 		inline warthog::jps::direction
-		compute_direction(warthog::search_node* n1, warthog::search_node* n2)
+		compute_direction(uint32_t n1_id, uint32_t n2_id)
 		{
-			if(n1 == 0) { return warthog::jps::NONE; }
+			if(n1_id == warthog::INF) { return warthog::jps::NONE; }
 
 			uint32_t x, y, x2, y2;
-			warthog::helpers::index_to_xy(n1->get_id(), map_->width(), x, y);
-			warthog::helpers::index_to_xy(n2->get_id(), map_->width(), x2, y2);
+			warthog::helpers::index_to_xy(n1_id, map_->width(), x, y);
+			warthog::helpers::index_to_xy(n2_id, map_->width(), x2, y2);
 			warthog::jps::direction dir = warthog::jps::NONE;
 			if(y2 == y)
 			{
@@ -0,0 +1,435 @@
+#include "gridmap.h"
+#include "jps.h"
+#include "jpsplus_preproc.h"
+#include "online_jump_point_locator.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// direction of travel for each label index (i.e. direction 1 << index)
+const int32_t DX[8] = { 0, 0, 1, -1,  1, -1, 1, -1};
+const int32_t DY[8] = {-1, 1, 0,  0, -1, -1, 1,  1};
+
+// sweeps carry the number of steps in the low bits of a uint32_t
+// and mark jumps that lead to dead-ends by setting the high bit
+const uint32_t DEADEND = 1u << 31;
+
+// the narrowest chunk of columns given to one thread by 
+// sweeper::sweep_vertical
+const uint32_t MIN_CHUNK_WIDTH = 64;
+
+// same conversion (and overflow check) as the online builder.
+// NB: check before narrowing; 15 bits hold the steps, bit 15 the flag
+inline uint16_t
+make_label(uint32_t steps, bool deadend)
+{
+	if(steps >= 32768)
+	{
+		std::cerr << "label overflow; maximum jump distance exceeded. aborting\n";
+		exit(1);
+	}
+	return (deadend ? 32768 : 0) | (uint16_t)steps;
+}
+
+// counts finished units of work (rows of the map) and reports progress.
+// units can be finished by any thread but only the thread that created 
+// the tracker invokes the callback (at most once for every percent).
+class progress_tracker
+{
+	public:
+		progress_tracker(warthog::jpsplus_preproc::progress_fn& fn,
+				uint32_t total)
+			: fn_(fn), total_(total), done_(0), last_report_(0),
+			owner_(std::this_thread::get_id())
+		{ }
+
+		inline void
+		tick()
+		{
+			uint32_t done = done_.fetch_add(1) + 1;
+			if(fn_ && std::this_thread::get_id() == owner_ &&
+					(uint64_t)(done - last_report_)*100 >= total_)
+			{
+				fn_(done, total_);
+				last_report_ = done;
+			}
+		}
+
+		inline void
+		finish()
+		{
+			if(fn_) { fn_(total_, total_); }
+		}
+
+	private:
+		warthog::jpsplus_preproc::progress_fn& fn_;
+		uint32_t total_;
+		std::atomic<uint32_t> done_;
+		uint32_t last_report_;
+		std::thread::id owner_;
+};
+
+// process work items [0, num_items) using @param nthreads threads
+// (the calling thread included)
+void
+run_parallel(uint32_t nthreads, uint32_t num_items,
+		std::function<void(uint32_t)> fn)
+{
+	std::atomic<uint32_t> next_item(0);
+	std::function<void()> work = [&]() {
+		for(uint32_t item = next_item.fetch_add(1); item < num_items;
+				item = next_item.fetch_add(1))
+		{
+			fn(item);
+		}
+	};
+
+	std::vector<std::thread*> threads;
+	for(uint32_t i = 1; i < nthreads && i < num_items; i++)
+	{
+		threads.push_back(new std::thread(work));
+	}
+	work();
+	for(uint32_t i = 0; i < threads.size(); i++)
+	{
+		threads[i]->join();
+		delete threads[i];
+	}
+}
+
+void
+compute_row_online(warthog::gridmap* map,
+		warthog::online_jump_point_locator* jpl, uint16_t* labels, uint32_t y)
+{
+	for(uint32_t x = 0; x < map->header_width(); x++)
+	{
+		uint32_t mapid = map->to_padded_id(x, y);
+		for(int i = 0; i < 8; i++)
+		{
+			warthog::jps::direction dir =
+				(warthog::jps::direction)(1 << i);
+			uint32_t jumpnode_id;
+			warthog::cost_t jumpcost;
+			jpl->jump(dir, mapid,
+					warthog::INF, jumpnode_id, jumpcost);
+
+			// convert from cost to number of steps
+			if(dir > 8)
+			{
+				jumpcost = (jumpcost / warthog::ROOT_TWO);
+			}
+			else
+			{
+				jumpcost = jumpcost / warthog::ONE;
+			}
+			uint32_t num_steps = (uint32_t)floor((jumpcost + 0.5));
+			labels[(size_t)mapid*8 + i] = 
+				make_label(num_steps, jumpnode_id == warthog::INF);
+		}
+	}
+}
+
+// the values that a chunk of sweeper::sweep_vertical passes on to its 
+// neighbours, for the last two rows that it finished
+class chunk_edges
+{
+	public:
+		struct edge
+		{
+			uint32_t east_;
+			uint32_t west_;
+		};
+
+		chunk_edges() : rows_done_(0) { }
+
+		// the outcome of diagonal jumps that reach the first (@param east)
+		// and the last (@param west) node of the chunk in row @param row
+		inline void
+		publish(int32_t row, uint32_t east, uint32_t west)
+		{
+			edge_[row & 1].east_ = east;
+			edge_[row & 1].west_ = west;
+			rows_done_.store(row + 1, std::memory_order_release);
+		}
+
+		// wait until row @param row is finished and return its values.
+		// NB: two rows suffice; a chunk never gets more than one row ahead
+		// of its neighbours
+		inline const edge&
+		wait(int32_t row)
+		{
+			while(rows_done_.load(std::memory_order_acquire) <= row)
+			{
+				std::this_thread::yield();
+			}
+			return edge_[row & 1];
+		}
+
+	private:
+		edge edge_[2];
+		std::atomic<int32_t> rows_done_;
+};
+
+// state shared by all sweeps over one map
+class sweeper
+{
+	public:
+		sweeper(warthog::gridmap* map, uint16_t* labels)
+			: map_(map), labels_(labels),
+			w_(map->header_width()), h_(map->header_height()),
+			pw_(map->width()), origin_(map->to_padded_id(0, 0)),
+			flags_(new uint8_t[(size_t)w_*h_]())
+		{ }
+
+		~sweeper() { delete [] flags_; }
+
+		// east and west labels for every node in row @param y.
+		void
+		sweep_row(int32_t y)
+		{
+			for(uint32_t i = 2; i < 4; i++)
+			{
+				int32_t dx = DX[i];
+				uint32_t next = DEADEND;
+				for(int32_t x = (dx > 0 ? w_-1 : 0); x >= 0 && x < w_; x -= dx)
+				{
+					next = straight(i, x, y, next);
+					uint8_t& f = flags_[(size_t)y*w_ + x];
+					if(!(next & DEADEND)) { f |= (1 << i); }
+					if(next == DEADEND) { f |= (16 << i); }
+				}
+			}
+		}
+
+		// vertical and diagonal labels, for every node in columns 
+		// [@param x0, @param x1), in the directions where y changes by 
+		// @param dy (i.e. N, NE, NW or S, SE, SW). rows are processed in 
+		// order, starting from the edge of the map that these jumps move 
+		// towards. requires every row to be swept.
+		//
+		// the columns of the map are split into chunks, given by 
+		// @param edges (one per chunk), which are swept at the same time.
+		// diagonal jumps cross from one chunk into the next, so before 
+		// each row a chunk waits until its neighbours have finished the 
+		// previous row. @param progress is advanced by the first chunk.
+		void
+		sweep_vertical(int32_t dy, int32_t x0, int32_t x1, chunk_edges* edges,
+				uint32_t chunk, uint32_t num_chunks, progress_tracker& progress)
+		{
+			uint32_t iv = dy < 0 ? 0 : 1;
+			uint32_t ie = dy < 0 ? 4 : 6;
+			uint32_t iw = dy < 0 ? 5 : 7;
+			uint8_t jp_v = (1 << iv);
+			uint8_t zero_v = (16 << iv);
+			chunk_edges* east_nei = chunk+1 < num_chunks ? &edges[chunk+1] : 0;
+			chunk_edges* west_nei = chunk > 0 ? &edges[chunk-1] : 0;
+
+			// values for the previous row (the row at y+dy) and the current
+			// row. for diagonals we store the outcome of a diagonal jump that
+			// reaches a node; entries 0 and x1-x0+1 are the nodes next to the
+			// chunk (sentinels at the edges of the map).
+			int32_t cw_size = x1 - x0;
+			std::vector<uint32_t> vert[2], east[2], west[2];
+			for(uint32_t k = 0; k < 2; k++)
+			{
+				vert[k].resize(cw_size+2, DEADEND);
+				east[k].resize(cw_size+2, DEADEND);
+				west[k].resize(cw_size+2, DEADEND);
+			}
+
+			int32_t row = 0;
+			for(int32_t y = (dy < 0 ? 0 : h_-1); y >= 0 && y < h_; y -= dy)
+			{
+				uint32_t* pv = &vert[0][1]; uint32_t* cv = &vert[1][1];
+				uint32_t* pe = &east[0][1]; uint32_t* ce = &east[1][1];
+				uint32_t* pw = &west[0][1]; uint32_t* cw = &west[1][1];
+				if(row > 0)
+				{
+					if(east_nei) { pe[cw_size] = east_nei->wait(row-1).east_; }
+					if(west_nei) { pw[-1] = west_nei->wait(row-1).west_; }
+				}
+
+				for(int32_t i = 0; i < cw_size; i++)
+				{
+					int32_t x = x0 + i;
+					cv[i] = straight(iv, x, y, pv[i]);
+					uint8_t f = flags_[(size_t)y*w_ + x];
+					if(!(cv[i] & DEADEND)) { f |= jp_v; }
+					if(cv[i] == DEADEND) { f |= zero_v; }
+
+					uint32_t mapid = padded_id(x, y);
+					labels_[(size_t)mapid*8 + ie] = diagonal(x, y, 1, dy, pe[i+1]);
+					labels_[(size_t)mapid*8 + iw] = diagonal(x, y, -1, dy, pw[i-1]);
+					ce[i] = reach(f, jp_v | 4, zero_v | 64, pe[i+1]);
+					cw[i] = reach(f, jp_v | 8, zero_v | 128, pw[i-1]);
+				}
+				edges[chunk].publish(row, ce[0], cw[cw_size-1]);
+
+				vert[0].swap(vert[1]);
+				east[0].swap(east[1]);
+				west[0].swap(west[1]);
+				if(chunk == 0) { progress.tick(); }
+				row++;
+			}
+		}
+
+		inline int32_t width() { return w_; }
+		inline int32_t height() { return h_; }
+
+	private:
+		warthog::gridmap* map_;
+		uint16_t* labels_;
+		int32_t w_;
+		int32_t h_;
+
+		// (x, y) has padded id origin_ + y*pw_ + x
+		int32_t pw_;
+		int32_t origin_;
+
+		// for each node and straight direction i: bit i is set if a jump
+		// reaches a jump point; bit 4+i if it is a dead-end after 0 steps.
+		// only the horizontal directions are stored.
+		uint8_t* flags_;
+
+		inline uint32_t
+		padded_id(int32_t x, int32_t y)
+		{
+			return origin_ + y*pw_ + x;
+		}
+
+		// NB: also valid one step outside the map, where the padding
+		// (which is never traversable) is read instead
+		inline bool
+		get(int32_t x, int32_t y)
+		{
+			return map_->get_label(padded_id(x, y));
+		}
+
+		// compute and store the label of (x, y) in straight direction @param i
+		// given the value @param next for the node after (x, y).
+		// the online locator stops at the first obstacle or forced 
+		// neighbour after (x, y). jumping from an obstacle, or into one, 
+		// costs zero steps.
+		// @return the value for (x, y)
+		inline uint32_t
+		straight(uint32_t i, int32_t x, int32_t y, uint32_t next)
+		{
+			int32_t dx = DX[i], dy = DY[i];
+			int32_t qx = x + dx, qy = y + dy;
+			uint32_t val;
+			if(!get(x, y) || !get(qx, qy))
+			{
+				val = DEADEND;
+			}
+			else if((get(qx+dy, qy+dx) && !get(x+dy, y+dx)) ||
+					(get(qx-dy, qy-dx) && !get(x-dy, y-dx)))
+			{
+				val = 1;
+			}
+			else
+			{
+				val = next + 1;
+			}
+			labels_[(size_t)padded_id(x, y)*8 + i] = 
+				make_label(val & ~DEADEND, val & DEADEND);
+			return val;
+		}
+
+		// @return the label of (x, y) for the diagonal (dx, dy), given the 
+		// outcome @param next of a diagonal jump that reaches (x+dx, y+dy)
+		inline uint16_t
+		diagonal(int32_t x, int32_t y, int32_t dx, int32_t dy, uint32_t next)
+		{
+			bool first_step = get(x, y) && get(x, y+dy) &&
+				get(x+dx, y) && get(x+dx, y+dy);
+			uint32_t val = first_step ? next : DEADEND;
+			return make_label(val & ~DEADEND, val & DEADEND);
+		}
+
+		// @return the outcome of a diagonal jump that reaches a node with 
+		// straight jump flags @param f, given the outcome @param next of 
+		// the same jump one step further. the online locator stops when 
+		// either straight component finds a jump point or when either 
+		// costs zero steps (i.e. the node is a dead-end).
+		inline uint32_t
+		reach(uint8_t f, uint8_t jp_mask, uint8_t zero_mask, uint32_t next)
+		{
+			if(f & jp_mask) { return 1; }
+			if(f & zero_mask) { return DEADEND | 1; }
+			return next + 1;
+		}
+};
+
+}
+
+uint32_t
+warthog::jpsplus_preproc::default_threads()
+{
+	uint32_t ncores = std::thread::hardware_concurrency();
+	return ncores == 0 ? 1 : ncores;
+}
+
+void
+warthog::jpsplus_preproc::compute_labels(warthog::gridmap* map,
+		uint16_t* labels, uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn progress)
+{
+	if(nthreads == 0) { nthreads = default_threads(); }
+	sweeper sw(map, labels);
+	int32_t h = sw.height();
+	progress_tracker tracker(progress, 3*h);
+
+	// rows (east and west), in parallel. then one pass top to bottom
+	// (north, northeast, northwest) and one bottom to top (south, southeast,
+	// southwest); the two passes are independent. each pass is split into 
+	// chunks of columns which must all run at the same time (see 
+	// sweeper::sweep_vertical), one thread each.
+	run_parallel(nthreads, h, [&](uint32_t y) {
+			sw.sweep_row(y);
+			tracker.tick();
+		});
+
+	int32_t w = sw.width();
+	uint32_t chunks = nthreads / 2;
+	if(chunks > (uint32_t)w / MIN_CHUNK_WIDTH)
+	{
+		chunks = w / MIN_CHUNK_WIDTH;
+	}
+	if(chunks == 0) { chunks = 1; }
+	chunk_edges* edges = new chunk_edges[2*chunks];
+	run_parallel(chunks == 1 ? nthreads : 2*chunks, 2*chunks, 
+			[&](uint32_t item) {
+				uint32_t pass = item / chunks;
+				uint32_t c = item % chunks;
+				sw.sweep_vertical(pass == 0 ? -1 : 1, 
+						c * w / chunks, (c+1) * w / chunks, 
+						edges + pass*chunks, c, chunks, tracker);
+			});
+	delete [] edges;
+	tracker.finish();
+}
+
+void
+warthog::jpsplus_preproc::compute_labels_online(warthog::gridmap* map,
+		uint16_t* labels, uint32_t nthreads,
+		warthog::jpsplus_preproc::progress_fn progress)
+{
+	if(nthreads == 0) { nthreads = default_threads(); }
+	uint32_t height = map->header_height();
+	progress_tracker tracker(progress, height);
+
+	// ::jump only reads the map, so one locator serves every thread
+	warthog::online_jump_point_locator jpl(map);
+	run_parallel(nthreads, height, [&](uint32_t y) {
+			compute_row_online(map, &jpl, labels, y);
+			tracker.tick();
+		});
+	tracker.finish();
+}
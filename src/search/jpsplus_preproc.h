@@ -0,0 +1,77 @@
+#ifndef WARTHOG_JPSPLUS_PREPROC_H
+#define WARTHOG_JPSPLUS_PREPROC_H
+
+// jpsplus_preproc.h
+//
+// Computes the jump labels used by warthog::offline_jump_point_locator
+// and warthog::offline_jump_point_locator2. Every node has 8 labels, one
+// for each direction (in the order N, S, E, W, NE, NW, SE, SW). The low
+// 15 bits of a label store the number of steps to the first jump point
+// (or obstacle) in that direction; bit 15 is set if the jump leads to a
+// dead-end.
+//
+// ::compute_labels builds the labels with one sweep per row, column and
+// diagonal of the map, in each direction. Every line is traversed from its 
+// far end back to its start; the label of a node is derived from the label 
+// of the node after it (e.g. one step east of a node with no obstacle or 
+// forced neighbour in the way, the east label is one step longer). Straight 
+// labels are computed first; a diagonal jump continues until one of its two 
+// straight components finds a jump point (or dead-ends immediately), so 
+// diagonal labels follow from the straight ones in the same manner. 
+// The total work is linear in the size of the map.
+//
+// ::compute_labels_online produces the same labels by jumping, online, 
+// from every node in every direction. It is much slower (quadratic in the 
+// length of corridors) and serves as a reference implementation.
+//
+// Both functions share the work among several threads: each thread 
+// repeatedly claims the next unfinished row and writes only the labels of 
+// nodes in that row. The vertical and diagonal sweeps of ::compute_labels 
+// instead split the columns of the map into chunks, one per thread, that 
+// move from row to row in step with each other. Every label is written by 
+// one thread only; the output is thus identical no matter how many threads
+// are used.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "gridmap.h"
+
+#include <functional>
+#include <stdint.h>
+
+namespace warthog
+{
+
+namespace jpsplus_preproc
+{
+
+// invoked with the number of work items (lines of the map) finished so far
+// and the total number of items. always called from the thread that 
+// invoked ::compute_labels.
+typedef std::function<void(uint32_t, uint32_t)> progress_fn;
+
+// @return the number of threads used when the caller does not specify one
+// (i.e. one thread for every core)
+uint32_t
+default_threads();
+
+// compute every label for @param map and write them to @param labels
+// (8*map->padded_mapsize() elements, zero-initialised).
+// @param nthreads: the number of worker threads (0 = ::default_threads)
+// @param progress: an optional progress callback
+void
+compute_labels(warthog::gridmap* map, uint16_t* labels,
+		uint32_t nthreads, warthog::jpsplus_preproc::progress_fn progress);
+
+// as above, but every label is found by an online jump
+void
+compute_labels_online(warthog::gridmap* map, uint16_t* labels,
+		uint32_t nthreads, warthog::jpsplus_preproc::progress_fn progress);
+
+}
+
+}
+
+#endif
@@ -0,0 +1,388 @@
+#include "jump_scan.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WARTHOG_JUMP_SCAN_X86
+#include <immintrin.h>
+#endif
+
+// Every kernel looks for the first (east) or last (west) tile of the 
+// current row which is an obstacle (a dead-end) or which has a forced 
+// neighbour: a traversable tile in the row above or below that follows
+// (in the direction of travel) an obstacle. The tile where the jump 
+// begins can be a dead-end (when jumping straight from a diagonal step
+// onto an obstacle) but its neighbours are never forced.
+//
+// Words are read from three rows: r0 (above), r1 (current) and r2 (below).
+// The bit which precedes the first bit of each word, in the direction of
+// travel, comes from a second read that is offset by one word. Vector 
+// kernels read up to three words past the end of a row (for the last row:
+// into the guard bytes of the map).
+
+namespace
+{
+
+// the tiles where a jump east stops, in word @param i of each row. 
+// a tile is forced if it is traversable and its western neighbour is not.
+// only dead-ends in @param dead_mask and forced tiles in @param 
+// forced_mask count; @param dead is set to the dead-end tiles.
+inline uint64_t
+stop_east(const uint64_t* r0, const uint64_t* r1, const uint64_t* r2, 
+		int32_t i, uint64_t dead_mask, uint64_t forced_mask, uint64_t& dead)
+{
+	uint64_t f0 = r0[i] & ~((r0[i] << 1) | (r0[i-1] >> 63));
+	uint64_t f2 = r2[i] & ~((r2[i] << 1) | (r2[i-1] >> 63));
+	dead = ~r1[i] & dead_mask;
+	return dead | ((f0 | f2) & forced_mask);
+}
+
+// as above, for a jump west (word -@param i of each row)
+inline uint64_t
+stop_west(const uint64_t* r0, const uint64_t* r1, const uint64_t* r2, 
+		int32_t i, uint64_t dead_mask, uint64_t forced_mask, uint64_t& dead)
+{
+	uint64_t f0 = r0[-i] & ~((r0[-i] >> 1) | (r0[1-i] << 63));
+	uint64_t f2 = r2[-i] & ~((r2[-i] >> 1) | (r2[1-i] << 63));
+	dead = ~r1[-i] & dead_mask;
+	return dead | ((f0 | f2) & forced_mask);
+}
+
+// most jumps end in the word where they begin; every kernel scans that
+// word first, without vector instructions. @return true and set 
+// @param steps and @param deadend if the jump ends there
+inline bool
+first_word_east(const uint64_t* r0, const uint64_t* r1, const uint64_t* r2,
+		uint32_t off, uint32_t& steps, bool& deadend)
+{
+	uint64_t dead;
+	uint64_t stop = stop_east(r0, r1, r2, 0, 
+			~0ULL << off, (~0ULL << off) << 1, dead);
+	if(!stop) { return false; }
+	uint32_t pos = __builtin_ctzll(stop);
+	deadend = (dead >> pos) & 1;
+	steps = pos - off;
+	return true;
+}
+
+inline bool
+first_word_west(const uint64_t* r0, const uint64_t* r1, const uint64_t* r2,
+		uint32_t off, uint32_t& steps, bool& deadend)
+{
+	// NB: 2 << 63 == 0; all bits are kept when off is 63
+	uint64_t dead;
+	uint64_t stop = stop_west(r0, r1, r2, 0, 
+			(2ULL << off) - 1, (1ULL << off) - 1, dead);
+	if(!stop) { return false; }
+	uint32_t pos = 63 - __builtin_clzll(stop);
+	deadend = (dead >> pos) & 1;
+	steps = off - pos;
+	return true;
+}
+
+// if not FIRST, the word of the first tile has been scanned by the caller
+// (see diagonal_rays) and the scan begins with the next word
+template<bool FIRST>
+uint32_t
+scalar_east(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_east(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	for(int32_t i = 1; ; i++)
+	{
+		uint64_t dead;
+		uint64_t stop = stop_east(r0, r1, r2, i, ~0ULL, ~0ULL, dead);
+		if(stop)
+		{
+			uint32_t pos = __builtin_ctzll(stop);
+			deadend = (dead >> pos) & 1;
+			return i*64 + pos - off;
+		}
+	}
+}
+
+template<bool FIRST>
+uint32_t
+scalar_west(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_west(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	for(int32_t i = 1; ; i++)
+	{
+		uint64_t dead;
+		uint64_t stop = stop_west(r0, r1, r2, i, ~0ULL, ~0ULL, dead);
+		if(stop)
+		{
+			uint32_t pos = 63 - __builtin_clzll(stop);
+			deadend = (dead >> pos) & 1;
+			return i*64 + off - pos;
+		}
+	}
+}
+
+#ifdef WARTHOG_JUMP_SCAN_X86
+
+// SSE2 is part of x86-64; on 32 bit targets this kernel is compiled
+// for SSE2 and only used if the CPU has it
+template<bool FIRST>
+__attribute__((target("sse2")))
+uint32_t
+sse2_east(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_east(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i ones = _mm_set1_epi32(-1);
+	for(int32_t i = 1; ; i += 2)
+	{
+		__m128i a0 = _mm_loadu_si128((const __m128i*)(r0 + i));
+		__m128i p0 = _mm_loadu_si128((const __m128i*)(r0 + i - 1));
+		__m128i a2 = _mm_loadu_si128((const __m128i*)(r2 + i));
+		__m128i p2 = _mm_loadu_si128((const __m128i*)(r2 + i - 1));
+		__m128i a1 = _mm_loadu_si128((const __m128i*)(r1 + i));
+
+		__m128i f0 = _mm_andnot_si128(_mm_or_si128(
+					_mm_slli_epi64(a0, 1), _mm_srli_epi64(p0, 63)), a0);
+		__m128i f2 = _mm_andnot_si128(_mm_or_si128(
+					_mm_slli_epi64(a2, 1), _mm_srli_epi64(p2, 63)), a2);
+		__m128i dead = _mm_andnot_si128(a1, ones);
+		__m128i stop = _mm_or_si128(dead, _mm_or_si128(f0, f2));
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(stop, zero)) != 0xffff)
+		{
+			uint64_t s[2], d[2];
+			_mm_storeu_si128((__m128i*)s, stop);
+			_mm_storeu_si128((__m128i*)d, dead);
+			uint32_t lane = s[0] ? 0 : 1;
+			uint32_t pos = __builtin_ctzll(s[lane]);
+			deadend = (d[lane] >> pos) & 1;
+			return (i + lane)*64 + pos - off;
+		}
+	}
+}
+
+// lanes hold words -i-1 and -i (relative to the word of the current tile)
+template<bool FIRST>
+__attribute__((target("sse2")))
+uint32_t
+sse2_west(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_west(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i ones = _mm_set1_epi32(-1);
+	for(int32_t i = 1; ; i += 2)
+	{
+		__m128i a0 = _mm_loadu_si128((const __m128i*)(r0 - i - 1));
+		__m128i n0 = _mm_loadu_si128((const __m128i*)(r0 - i));
+		__m128i a2 = _mm_loadu_si128((const __m128i*)(r2 - i - 1));
+		__m128i n2 = _mm_loadu_si128((const __m128i*)(r2 - i));
+		__m128i a1 = _mm_loadu_si128((const __m128i*)(r1 - i - 1));
+
+		__m128i f0 = _mm_andnot_si128(_mm_or_si128(
+					_mm_srli_epi64(a0, 1), _mm_slli_epi64(n0, 63)), a0);
+		__m128i f2 = _mm_andnot_si128(_mm_or_si128(
+					_mm_srli_epi64(a2, 1), _mm_slli_epi64(n2, 63)), a2);
+		__m128i dead = _mm_andnot_si128(a1, ones);
+		__m128i stop = _mm_or_si128(dead, _mm_or_si128(f0, f2));
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(stop, zero)) != 0xffff)
+		{
+			uint64_t s[2], d[2];
+			_mm_storeu_si128((__m128i*)s, stop);
+			_mm_storeu_si128((__m128i*)d, dead);
+			uint32_t lane = s[1] ? 1 : 0;
+			uint32_t pos = 63 - __builtin_clzll(s[lane]);
+			deadend = (d[lane] >> pos) & 1;
+			return (i + 1 - lane)*64 + off - pos;
+		}
+	}
+}
+
+template<bool FIRST>
+__attribute__((target("avx2")))
+uint32_t
+avx2_east(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_east(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	__m256i ones = _mm256_set1_epi32(-1);
+	for(int32_t i = 1; ; i += 4)
+	{
+		__m256i a0 = _mm256_loadu_si256((const __m256i*)(r0 + i));
+		__m256i p0 = _mm256_loadu_si256((const __m256i*)(r0 + i - 1));
+		__m256i a2 = _mm256_loadu_si256((const __m256i*)(r2 + i));
+		__m256i p2 = _mm256_loadu_si256((const __m256i*)(r2 + i - 1));
+		__m256i a1 = _mm256_loadu_si256((const __m256i*)(r1 + i));
+
+		__m256i f0 = _mm256_andnot_si256(_mm256_or_si256(
+					_mm256_slli_epi64(a0, 1), _mm256_srli_epi64(p0, 63)), a0);
+		__m256i f2 = _mm256_andnot_si256(_mm256_or_si256(
+					_mm256_slli_epi64(a2, 1), _mm256_srli_epi64(p2, 63)), a2);
+		__m256i dead = _mm256_andnot_si256(a1, ones);
+		__m256i stop = _mm256_or_si256(dead, _mm256_or_si256(f0, f2));
+
+		if(!_mm256_testz_si256(stop, stop))
+		{
+			uint64_t s[4], d[4];
+			_mm256_storeu_si256((__m256i*)s, stop);
+			_mm256_storeu_si256((__m256i*)d, dead);
+			uint32_t lane = 0;
+			while(!s[lane]) { lane++; }
+			uint32_t pos = __builtin_ctzll(s[lane]);
+			deadend = (d[lane] >> pos) & 1;
+			return (i + lane)*64 + pos - off;
+		}
+	}
+}
+
+// lanes hold words -i-3 .. -i (relative to the word of the current tile)
+template<bool FIRST>
+__attribute__((target("avx2")))
+uint32_t
+avx2_west(const uint64_t* words, uint32_t width, uint32_t id, bool& deadend)
+{
+	const uint64_t* r1 = words + (id >> 6);
+	const uint64_t* r0 = r1 - (width >> 6);
+	const uint64_t* r2 = r1 + (width >> 6);
+	uint32_t off = id & 63;
+	uint32_t steps;
+	if(FIRST && first_word_west(r0, r1, r2, off, steps, deadend))
+	{
+		return steps;
+	}
+
+	__m256i ones = _mm256_set1_epi32(-1);
+	for(int32_t i = 1; ; i += 4)
+	{
+		__m256i a0 = _mm256_loadu_si256((const __m256i*)(r0 - i - 3));
+		__m256i n0 = _mm256_loadu_si256((const __m256i*)(r0 - i - 2));
+		__m256i a2 = _mm256_loadu_si256((const __m256i*)(r2 - i - 3));
+		__m256i n2 = _mm256_loadu_si256((const __m256i*)(r2 - i - 2));
+		__m256i a1 = _mm256_loadu_si256((const __m256i*)(r1 - i - 3));
+
+		__m256i f0 = _mm256_andnot_si256(_mm256_or_si256(
+					_mm256_srli_epi64(a0, 1), _mm256_slli_epi64(n0, 63)), a0);
+		__m256i f2 = _mm256_andnot_si256(_mm256_or_si256(
+					_mm256_srli_epi64(a2, 1), _mm256_slli_epi64(n2, 63)), a2);
+		__m256i dead = _mm256_andnot_si256(a1, ones);
+		__m256i stop = _mm256_or_si256(dead, _mm256_or_si256(f0, f2));
+
+		if(!_mm256_testz_si256(stop, stop))
+		{
+			uint64_t s[4], d[4];
+			_mm256_storeu_si256((__m256i*)s, stop);
+			_mm256_storeu_si256((__m256i*)d, dead);
+			uint32_t lane = 3;
+			while(!s[lane]) { lane--; }
+			uint32_t pos = 63 - __builtin_clzll(s[lane]);
+			deadend = (d[lane] >> pos) & 1;
+			return (i + 3 - lane)*64 + off - pos;
+		}
+	}
+}
+
+#endif
+
+const warthog::jump_scan::kernel kernels[] = 
+{
+	{"scalar", scalar_east<true>, scalar_west<true>, 
+		scalar_east<false>, scalar_west<false>},
+#ifdef WARTHOG_JUMP_SCAN_X86
+	{"sse2", sse2_east<true>, sse2_west<true>, 
+		sse2_east<false>, sse2_west<false>},
+	{"avx2", avx2_east<true>, avx2_west<true>, 
+		avx2_east<false>, avx2_west<false>},
+#endif
+};
+const uint32_t num_kernels = sizeof(kernels) / sizeof(kernels[0]);
+
+bool
+supported(const warthog::jump_scan::kernel& k)
+{
+#ifdef WARTHOG_JUMP_SCAN_X86
+	__builtin_cpu_init();
+	if(k.east_ == sse2_east<true>) { return __builtin_cpu_supports("sse2"); }
+	if(k.east_ == avx2_east<true>) { return __builtin_cpu_supports("avx2"); }
+#endif
+	return true;
+}
+
+const warthog::jump_scan::kernel*
+find(const char* name)
+{
+	for(uint32_t i = 0; name && i < num_kernels; i++)
+	{
+		if(!strcmp(name, kernels[i].name_) && supported(kernels[i]))
+		{
+			return &kernels[i];
+		}
+	}
+	return 0;
+}
+
+const warthog::jump_scan::kernel&
+best()
+{
+	const warthog::jump_scan::kernel* k = find(getenv("WARTHOG_JUMP_SCAN"));
+	if(k) { return *k; }
+	for(uint32_t i = num_kernels; i > 0; i--)
+	{
+		if(supported(kernels[i-1])) { return kernels[i-1]; }
+	}
+	return kernels[0];
+}
+
+}
+
+const warthog::jump_scan::kernel&
+warthog::jump_scan::get_kernel(const char* name)
+{
+	const warthog::jump_scan::kernel* k = find(name);
+	if(k) { return *k; }
+
+	// chosen once; thread-safe as per C++11
+	static const warthog::jump_scan::kernel& chosen = best();
+	return chosen;
+}
@@ -0,0 +1,180 @@
+#ifndef WARTHOG_JUMP_SCAN_H
+#define WARTHOG_JUMP_SCAN_H
+
+// jump_scan.h
+//
+// Kernels for the straight (east and west) jumps of online jump point 
+// search. From a tile, a kernel scans three adjacent rows of a 
+// warthog::gridmap (the row of the tile, above and below) for the first 
+// tile in the direction of travel that is a dead-end (an obstacle on the 
+// middle row) or that has a forced neighbour (a traversable tile, above or
+// below, that follows an obstacle). North and south jumps use the same 
+// kernels on a rotated copy of the map.
+//
+// Three kernels are available:
+//  - scalar: 64 tiles per row and iteration
+//  - sse2: 128 tiles per row and iteration
+//  - avx2: 256 tiles per row and iteration
+// The vector kernels read whole, word-aligned blocks of each row and take 
+// the bits that cross word boundaries from a second, overlapping, load.
+// ::get_kernel picks the fastest kernel the CPU supports when first 
+// called (avx2 is compiled for that function alone, so the library runs 
+// on any x86-64 CPU). The environment variable WARTHOG_JUMP_SCAN 
+// (scalar, sse2 or avx2) overrides the choice; all kernels return the
+// same results, so the scalar kernel serves to verify the others.
+//
+// Kernels need the padded width of the map to be a multiple of 64 (true
+// of warthog::gridmap) and the guard bytes around it.
+//
+// ::diagonal_rays applies the same tests to the straight jumps which a
+// diagonal jump makes at every step (see online_jump_point_locator).
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "gridmap.h"
+
+#include <stdint.h>
+
+namespace warthog
+{
+
+namespace jump_scan
+{
+
+// @param words: the map (gridmap::get_words64)
+// @param width: the padded width of the map
+// @param id: the (padded) id of the tile where the jump begins
+// @param deadend: set to true if the jump stops at a dead-end tile
+// @return the number of steps from @param id to the tile where the jump
+// stops (a dead-end tile or a tile with a forced neighbour)
+typedef uint32_t (*scan_fn)(const uint64_t* words, uint32_t width, 
+		uint32_t id, bool& deadend);
+
+struct kernel
+{
+	const char* name_;
+	scan_fn east_;
+	scan_fn west_;
+
+	// as above, but the tiles in the word of @param id have been scanned
+	// already: the scan begins with the next word (east) or the word 
+	// before (west). @param id must be the last (east) or first (west)
+	// tile of its word. see ::diagonal_rays
+	scan_fn east_next_;
+	scan_fn west_next_;
+};
+
+// @return the kernel called @param name ("scalar", "sse2" or "avx2") or,
+// if @param name is null or the CPU does not support it, the fastest 
+// kernel for this CPU (subject to WARTHOG_JUMP_SCAN)
+const warthog::jump_scan::kernel&
+get_kernel(const char* name = 0);
+
+
+// the outcome of a straight jump (see ::diagonal_rays::next): it finds
+// a jump point or the goal, it cannot take a single step or neither.
+static const uint32_t RAY_OPEN = 0;
+static const uint32_t RAY_BLOCKED = 1;
+static const uint32_t RAY_JP = 2;
+
+// The straight jumps, east (if @tparam EAST) or west, from consecutive 
+// tiles of a diagonal, which moves one row up or down at every step.
+//
+// At every step the three words which hold the current tile and the tiles
+// above and below it are read and the dead-ends and forced neighbours in 
+// them are found with the same bitwise tests as the kernels, for all the 
+// tiles from the current one to the end of the word at once. Most 
+// straight jumps from a diagonal stop inside these words; only those that
+// run past them are handed to the kernel, which begins with the next word.
+template<bool EAST>
+class diagonal_rays
+{
+	public:
+		// @param id is the tile where the diagonal begins (step 0); the
+		// diagonal moves a row down if @param down, else up.
+		// @param fn continues the jumps (kernel::east_next_ or west_next_)
+		diagonal_rays(warthog::gridmap* map, warthog::jump_scan::scan_fn fn,
+				uint32_t id, bool down, uint32_t goal_id)
+			: words_(map->get_words64()), width_(map->width()), scan_(fn),
+			  id_(id), goal_id_(goal_id), 
+			  row_step_(down ? (int32_t)map->width() : -(int32_t)map->width())
+		{ }
+
+		// take the next step along the diagonal and jump straight.
+		// @return RAY_OPEN, RAY_BLOCKED or RAY_JP (see above)
+		inline uint32_t
+		next()
+		{
+			id_ += row_step_ + (EAST ? 1 : -1);
+			uint32_t bit = id_ & 63;
+			uint32_t word = id_ >> 6;
+			uint64_t above = words_[word - (width_ >> 6)];
+			uint64_t row = words_[word];
+			uint64_t below = words_[word + (width_ >> 6)];
+
+			// as the kernels: dead-ends from the current tile on, forced 
+			// neighbours after it. a tile is forced if it is traversable 
+			// and the tile before it (in the direction of travel) is not.
+			// the first tile of each word is never forced here; if need
+			// be, the kernel checks it (along with the word before it).
+			uint32_t steps;
+			bool deadend;
+			if(EAST)
+			{
+				uint64_t from = ~0ULL << bit;
+				uint64_t dead = ~row & from;
+				uint64_t stop = dead | ((from << 1) &
+					((above & ~(above << 1)) | (below & ~(below << 1))));
+				if(stop)
+				{
+					uint32_t pos = __builtin_ctzll(stop);
+					steps = pos - bit;
+					deadend = (dead >> pos) & 1;
+				}
+				else
+				{
+					steps = (63 - bit) + 
+						scan_(words_, width_, word*64 + 63, deadend);
+				}
+			}
+			else
+			{
+				// NB: 2 << 63 == 0; all bits are kept when bit is 63
+				uint64_t to = (2ULL << bit) - 1;
+				uint64_t dead = ~row & to;
+				uint64_t stop = dead | ((to >> 1) &
+					((above & ~(above >> 1)) | (below & ~(below >> 1))));
+				if(stop)
+				{
+					uint32_t pos = 63 - __builtin_clzll(stop);
+					steps = bit - pos;
+					deadend = (dead >> pos) & 1;
+				}
+				else
+				{
+					steps = bit + scan_(words_, width_, word*64, deadend);
+				}
+			}
+
+			// as per online_jump_point_locator::__jump_east
+			uint32_t goal_dist = EAST ? goal_id_ - id_ : id_ - goal_id_;
+			if(steps > goal_dist || !deadend) { return RAY_JP; }
+			return steps <= 1 ? RAY_BLOCKED : RAY_OPEN;
+		}
+
+	private:
+		const uint64_t* words_;
+		uint32_t width_;
+		warthog::jump_scan::scan_fn scan_;
+		uint32_t id_; // the current tile
+		uint32_t goal_id_;
+		int32_t row_step_;
+};
+
+}
+
+}
+
+#endif
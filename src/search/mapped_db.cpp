@@ -0,0 +1,147 @@
+#include "gridmap.h"
+#include "mapped_db.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+warthog::mapped_db::mapped_db(warthog::gridmap* map, const char* suffix,
+		uint32_t kind, uint32_t version, const char* desc)
+	: map_(map), kind_(kind), version_(version), desc_(desc), hdr_(0),
+	mapping_(0), mapping_size_(0)
+{
+	snprintf(fname_, sizeof(fname_), "%s%s", map_->filename(), suffix);
+}
+
+warthog::mapped_db::~mapped_db()
+{
+	release();
+}
+
+void
+warthog::mapped_db::release()
+{
+	if(mapping_)
+	{
+		munmap(mapping_, mapping_size_);
+		mapping_ = 0;
+		mapping_size_ = 0;
+	}
+	hdr_ = 0;
+}
+
+void
+warthog::mapped_db::init_header(warthog::mapped_db_ns::header& hdr)
+{
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic_, warthog::mapped_db_ns::MAGIC, sizeof(hdr.magic_));
+	hdr.version_ = version_;
+	hdr.endian_marker_ = warthog::mapped_db_ns::ENDIAN_MARKER;
+	hdr.kind_ = kind_;
+	hdr.header_width_ = map_->header_width();
+	hdr.header_height_ = map_->header_height();
+	hdr.padded_width_ = map_->width();
+	hdr.padded_height_ = map_->height();
+	hdr.map_checksum_ = map_->checksum();
+}
+
+bool
+warthog::mapped_db::load(const warthog::mapped_db_ns::layout_fn& layout)
+{
+	release();
+	std::cerr << "loading "<<fname_ << "... ";
+
+	int fd = open(fname_, O_RDONLY);
+	if(fd == -1)
+	{
+		std::cerr << "no dice. oh well. keep going.\n"<<std::endl;
+		return false;
+	}
+
+	struct stat st;
+	warthog::mapped_db_ns::header hdr;
+	if(fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(hdr) ||
+			read(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr))
+	{
+		std::cerr << "cannot read header; "<<desc_<<" is stale.\n";
+		close(fd);
+		return false;
+	}
+
+	// everything up to the payload size describes the map
+	warthog::mapped_db_ns::header expected;
+	init_header(expected);
+	if(memcmp(&hdr, &expected, offsetof(warthog::mapped_db_ns::header,
+					payload_size_)) != 0 ||
+			layout(hdr.params_) != hdr.payload_size_ ||
+			(uint64_t)st.st_size != sizeof(hdr) + hdr.payload_size_)
+	{
+		std::cerr << "header mismatch; "<<desc_<<" is stale.\n";
+		close(fd);
+		return false;
+	}
+
+	size_t size = sizeof(hdr) + hdr.payload_size_;
+	void* addr = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(addr == MAP_FAILED)
+	{
+		std::cerr << "mmap failed.\n";
+		return false;
+	}
+
+	mapping_ = addr;
+	mapping_size_ = size;
+	hdr_ = (const warthog::mapped_db_ns::header*)addr;
+	std::cerr << "done.\n";
+	return true;
+}
+
+bool
+warthog::mapped_db::save(const uint64_t* params,
+		const warthog::mapped_db_ns::block* blocks, uint32_t num_blocks)
+{
+	char tmpname[sizeof(fname_) + 32];
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp.%d", fname_, (int)getpid());
+	std::cerr << "saving "<<desc_<<" to file "<<fname_<<std::endl;
+
+	FILE* f = fopen(tmpname, "wb");
+	if(f == NULL)
+	{
+		std::cerr << "err; cannot write "<<desc_<<" to file "
+			<<tmpname<<". oh well. try to keep going.\n"<<std::endl;
+		return false;
+	}
+
+	warthog::mapped_db_ns::header hdr;
+	init_header(hdr);
+	for(uint32_t i = 0; params && i < warthog::mapped_db_ns::NUM_PARAMS; i++)
+	{
+		hdr.params_[i] = params[i];
+	}
+	for(uint32_t i = 0; i < num_blocks; i++)
+	{
+		hdr.payload_size_ += blocks[i].size_;
+	}
+
+	bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+	for(uint32_t i = 0; ok && i < num_blocks; i++)
+	{
+		ok = blocks[i].size_ == 0 ||
+			fwrite(blocks[i].data_, blocks[i].size_, 1, f) == 1;
+	}
+	ok = (fclose(f) == 0) && ok;
+	if(!ok || rename(tmpname, fname_) != 0)
+	{
+		std::cerr << "err; failed writing "<<desc_<<" to file "
+			<<fname_<<". oh well. try to keep going.\n"<<std::endl;
+		remove(tmpname);
+		return false;
+	}
+	std::cerr << desc_<<" saved to disk. file="<<fname_<<std::endl;
+	return true;
+}
@@ -0,0 +1,147 @@
+#ifndef WARTHOG_MAPPED_DB_H
+#define WARTHOG_MAPPED_DB_H
+
+// mapped_db.h
+//
+// The on-disk format shared by every database that is computed from a
+// grid map and stored next to it: jump labels (warthog::jpsplus_db),
+// compressed path databases (warthog::cpd), landmark distances
+// (warthog::landmark_heuristic) and goal bounds (warthog::goal_bounding).
+//
+// Each file begins with a fixed-size header that records a magic string,
+// the kind of database, the version of its layout, an endianness marker,
+// the dimensions of the map, a checksum of the map data (see
+// gridmap::checksum), a few parameters chosen by the owner of the file
+// (e.g. the number of nodes) and the size of the payload that follows.
+// A file is only used if every field matches the current map and if the
+// parameters describe a payload of the recorded size; otherwise the owner
+// recomputes the database and replaces the file.
+//
+// Existing files are mapped read-only into memory (mmap) rather than
+// read into a private buffer. Startup is therefore independent of the
+// size of the database and every process working with the same map
+// shares a single copy of the data in the page cache.
+//
+// New files are written to a temporary name and then renamed, so
+// readers never see a partially written database.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "gridmap.h"
+
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+
+namespace warthog
+{
+
+namespace mapped_db_ns
+{
+	static const char MAGIC[8] = {'W', 'D', 'B', 0, 0, 0, 0, 0};
+	static const uint32_t ENDIAN_MARKER = 0x01020304;
+
+	// kinds of database
+	static const uint32_t JPSPLUS = 1;
+	static const uint32_t JPS2PLUS = 2;
+	static const uint32_t CPD = 3;
+	static const uint32_t LANDMARKS = 4;
+	static const uint32_t GOAL_BOUNDS = 5;
+
+	static const uint32_t NUM_PARAMS = 8;
+
+	// 128 bytes, so that a mapped payload is cache-aligned
+	struct header
+	{
+		char magic_[8];
+		uint32_t version_;
+		uint32_t endian_marker_;
+		uint32_t kind_;
+		uint32_t header_width_;
+		uint32_t header_height_;
+		uint32_t padded_width_;
+		uint32_t padded_height_;
+		uint32_t map_checksum_;
+		uint64_t payload_size_; // in bytes
+		uint64_t params_[NUM_PARAMS];
+		uint64_t reserved_[2];
+	};
+
+	// one contiguous piece of a payload
+	struct block
+	{
+		const void* data_;
+		size_t size_;
+	};
+
+	// @return the size (in bytes) of the payload described by the
+	// parameters of a header, or UNSUITABLE if the owner cannot use a file
+	// with those parameters
+	typedef std::function<uint64_t(const uint64_t* params)> layout_fn;
+	static const uint64_t UNSUITABLE = ~(uint64_t)0;
+}
+
+class mapped_db
+{
+	public:
+		// the file is named after the map, plus @param suffix.
+		// @param kind and @param version identify the layout of the
+		// payload; @param desc names the contents in messages.
+		mapped_db(warthog::gridmap* map, const char* suffix, uint32_t kind,
+				uint32_t version, const char* desc);
+		~mapped_db();
+
+		// map the file associated with the current map.
+		// @return false if the file does not exist or if it is stale.
+		bool
+		load(const warthog::mapped_db_ns::layout_fn& layout);
+
+		// write @param num_blocks blocks, in order, after a header with
+		// parameters @param params (NUM_PARAMS of them; 0 = all zero)
+		bool
+		save(const uint64_t* params,
+				const warthog::mapped_db_ns::block* blocks,
+				uint32_t num_blocks);
+
+		// unmap the file, if any
+		void
+		release();
+
+		inline bool
+		is_mapped() { return mapping_ != 0; }
+
+		// the parameters and the payload of the mapped file
+		inline const uint64_t*
+		params() { return hdr_ ? hdr_->params_ : 0; }
+
+		inline const char*
+		payload() { return hdr_ ? (const char*)(hdr_ + 1) : 0; }
+
+		inline const char*
+		filename() { return fname_; }
+
+	private:
+		warthog::gridmap* map_;
+		uint32_t kind_;
+		uint32_t version_;
+		const char* desc_;
+		char fname_[264]; // map filename (max 256 chars) + suffix
+
+		const warthog::mapped_db_ns::header* hdr_;
+		void* mapping_;
+		size_t mapping_size_;
+
+		void
+		init_header(warthog::mapped_db_ns::header& hdr);
+
+		// no copy
+		mapped_db(const mapped_db& other) { }
+		mapped_db&
+		operator=(const mapped_db& other) { return *this; }
+};
+
+}
+
+#endif
@@ -1,137 +1,57 @@
 #define __STDC_FORMAT_MACROS
 #include "gridmap.h"
-#include "online_jump_point_locator.h"
 #include "offline_jump_point_locator.h"
+#include "timer.h"
 
 #include <cstring>
 #include <inttypes.h>
 #include <stdio.h>
 
 warthog::offline_jump_point_locator::offline_jump_point_locator(
-		warthog::gridmap* map) : map_(map)
+		warthog::gridmap* map, uint32_t nthreads, 
+		warthog::jpsplus_preproc::progress_fn progress) 
+	: map_(map), preproc_time_(0)
 {
-	preproc();
+	preproc(nthreads, progress);
 }
 
 warthog::offline_jump_point_locator::~offline_jump_point_locator()
 {
-	delete [] db_;
+	delete jpdb_;
 }
 
 void
-warthog::offline_jump_point_locator::preproc()
+warthog::offline_jump_point_locator::preproc(uint32_t nthreads, 
+		warthog::jpsplus_preproc::progress_fn progress)
 {
-	if(load(map_->filename())) { return; }
-
-	dbsize_ = 8*map_->padded_mapsize();
-	db_ = new uint16_t[dbsize_];
-	for(uint32_t i=0; i < dbsize_; i++) db_[i] = 0;
-
-	warthog::online_jump_point_locator jpl(map_);
-	for(uint32_t y = 0; y < map_->header_height(); y++)
+	jpdb_ = new warthog::jpsplus_db(map_, warthog::jpsplus_db_ns::JPSPLUS);
+	if(jpdb_->load())
 	{
-		for(uint32_t x = 0; x < map_->header_width(); x++)
-		{
-			uint32_t mapid = map_->to_padded_id(x, y);
-//			std::cout << mapid << " ";
-			for(int i = 0; i < 8; i++)
-			{
-				warthog::jps::direction dir = 
-					(warthog::jps::direction)(1 << i);
-//				std::cout << dir << ": ";
-				uint32_t jumpnode_id;
-				warthog::cost_t jumpcost;
-				jpl.jump(dir, mapid,
-						warthog::INF, jumpnode_id, jumpcost);
-				
-				// convert from cost to number of steps
-				if(dir > 8)
-				{
-					jumpcost = (jumpcost / warthog::ROOT_TWO);
-				}
-				uint32_t num_steps = (uint16_t)floor((jumpcost + 0.5));
-//				std::cout << (jumpnode_id == warthog::INF ? 0 : num_steps) << " ";
-
-				// set the leading bit if the jump leads to a dead-end
-				if(jumpnode_id == warthog::INF)
-				{
-					db_[mapid*8 + i] |= 32768;
-				}
-
-				// truncate jump cost so we can fit the label into a single byte
-				//if(num_steps > 32767)
-				//{
-				//	num_steps = 32767;
-				//	jumpnode_id = 0; 
-				//}
-
-				db_[mapid*8 + i] |= num_steps;
-
-				if(num_steps > 32768)
-				{
-					std::cerr << "label overflow; maximum jump distance exceeded. aborting\n";
-					exit(1);
-				}
-			}
-//			std::cout << std::endl;
-		}
+		db_ = jpdb_->labels();
+		return;
 	}
 
-	save(map_->filename());
-}
-
+	uint16_t* labels = jpdb_->create();
+	db_ = labels;
 
-bool
-warthog::offline_jump_point_locator::load(const char* filename)
-{
-	char fname[256];
-	strcpy(fname, filename);
-	strcat(fname, ".jps+");
-	FILE* f = fopen(fname, "rb");
-	std::cerr << "loading "<<fname << "... ";
-	if(f == NULL) 
-	{
-		std::cerr << "no dice. oh well. keep going.\n"<<std::endl;
-		return false;
-	}
-	
-	fread(&dbsize_, sizeof(dbsize_), 1, f);
-	std::cerr <<"#labels="<<dbsize_<<std::endl;
+	if(nthreads == 0) { nthreads = warthog::jpsplus_preproc::default_threads(); }
+	warthog::timer mytimer;
+	mytimer.start();
+	warthog::jpsplus_preproc::compute_labels(map_, labels, nthreads, progress);
+	mytimer.stop();
+	preproc_time_ = mytimer.elapsed_time_micro();
+	std::cerr << "jump-point database computed in " 
+		<< preproc_time_ / 1e6 << "s using " << nthreads << " thread(s)\n";
 
-	db_ = new uint16_t[dbsize_];
-	fread(db_, sizeof(uint16_t), dbsize_, f);
-	fclose(f);
-	return true;
+	jpdb_->save();
 }
 
-void 
-warthog::offline_jump_point_locator::save(const char* filename)
-{
-	char fname[256];
-	strcpy(fname, filename);
-	strcat(fname, ".jps+");
-	std::cerr << "saving to file "<<fname<<"; nodes="<<dbsize_<<" size: "<<sizeof(db_[0])<<std::endl;
-
-	FILE* f = fopen(fname, "wb");
-	if(f == NULL) 
-	{
-		std::cerr << "err; cannot write jump-point graph to file "
-			<<fname<<". oh well. try to keep going.\n"<<std::endl;
-		return;
-	}
-
-	fwrite(&dbsize_, sizeof(dbsize_), 1, f);
-	fwrite(db_, sizeof(*db_), dbsize_, f);
-	fclose(f);
-	std::cerr << "jump-point graph saved to disk. file="<<fname<<std::endl;
-}
 
 void
 warthog::offline_jump_point_locator::jump(warthog::jps::direction d, 
 		uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
 		warthog::cost_t& jumpcost)
 {
-	current_ = max_ = 0;
 	switch(d)
 	{
 		case warthog::jps::NORTH:
@@ -168,7 +88,7 @@ warthog::offline_jump_point_locator::jump_northwest(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t mapw = map_->width();
-	uint16_t label = db_[8*node_id + 5];
+	uint16_t label = db_[8*(size_t)node_id + 5];
 	uint16_t num_steps = label & 32767;
 
 	// goal test (so many div ops! and branches! how ugly!)
@@ -222,7 +142,7 @@ void
 warthog::offline_jump_point_locator::jump_northeast(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 4];
+	uint16_t label = db_[8*(size_t)node_id + 4];
 	uint16_t num_steps = label & 32767;
 	uint32_t mapw = map_->width();
 
@@ -277,7 +197,7 @@ void
 warthog::offline_jump_point_locator::jump_southwest(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 7];
+	uint16_t label = db_[8*(size_t)node_id + 7];
 	uint16_t num_steps = label & 32767;
 	uint32_t mapw = map_->width();
 
@@ -333,7 +253,7 @@ void
 warthog::offline_jump_point_locator::jump_southeast(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 6];
+	uint16_t label = db_[8*(size_t)node_id + 6];
 	uint16_t num_steps = label & 32767;
 	uint32_t mapw = map_->width();
 	
@@ -387,7 +307,7 @@ void
 warthog::offline_jump_point_locator::jump_north(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id];
+	uint16_t label = db_[8*(size_t)node_id];
 	uint16_t num_steps = label & 32767;
 
 	// do not jump over the goal
@@ -415,7 +335,7 @@ void
 warthog::offline_jump_point_locator::jump_south(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 1];
+	uint16_t label = db_[8*(size_t)node_id + 1];
 	uint16_t num_steps = label & 32767;
 	
 	// do not jump over the goal
@@ -443,7 +363,7 @@ void
 warthog::offline_jump_point_locator::jump_east(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 2];
+	uint16_t label = db_[8*(size_t)node_id + 2];
 
 	// do not jump over the goal
 	uint32_t id_delta = label & 32767;
@@ -465,7 +385,7 @@ void
 warthog::offline_jump_point_locator::jump_west(uint32_t node_id,
 	  	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	uint16_t label = db_[8*node_id + 3];
+	uint16_t label = db_[8*(size_t)node_id + 3];
 
 	// do not jump over the goal
 	uint32_t id_delta = label & 32767;
@@ -6,43 +6,53 @@
 // Identifies jump points using a pre-computed database that stores
 // distances from each node to jump points in every direction.
 //
+// Thread safety: the database is computed (or loaded) once, by the 
+// constructor. After that ::jump only reads the database and the map, so 
+// a single locator can be shared by any number of threads without locks.
+//
 // @author: dharabor
 // @created: 05/05/2013
 //
 
+#include "gridmap.h"
 #include "jps.h"
+#include "jpsplus_db.h"
+#include "jpsplus_preproc.h"
 
 namespace warthog
 {
 
-class gridmap;
 class offline_jump_point_locator
 {
 	public:
-		offline_jump_point_locator(warthog::gridmap* map);
+		// the jump database is loaded from disk or, if no valid copy 
+		// exists, computed using @param nthreads threads (0 = one per core).
+		// @param progress, if given, is called as preprocessing advances.
+		offline_jump_point_locator(warthog::gridmap* map, uint32_t nthreads = 0,
+				warthog::jpsplus_preproc::progress_fn progress = 
+				warthog::jpsplus_preproc::progress_fn());
 		~offline_jump_point_locator();
 
 		void
 		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 
+		// time (in microseconds) spent computing the database; 
+		// zero if the database was loaded from disk
+		inline double
+		get_preproc_time() { return preproc_time_; }
+
 		uint32_t
 		mem()
 		{
-			return sizeof(this) + sizeof(*db_)*dbsize_;
+			return sizeof(*this) + jpdb_->mem();
 		}
 
 
 	private:
 
 		void
-		preproc();
-
-		bool
-		load(const char* filename);
-
-		void 
-		save(const char* filename);
+		preproc(uint32_t nthreads, warthog::jpsplus_preproc::progress_fn progress);
 
 		void
 		jump_northwest(uint32_t node_id, uint32_t goal_id, 
@@ -70,13 +80,9 @@ class offline_jump_point_locator
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 
 		warthog::gridmap* map_;
-		uint32_t dbsize_;
-		uint16_t* db_;	
-
-		uint32_t jumppoints_[3];
-		warthog::cost_t costs_[3];
-		uint32_t max_;
-		uint32_t current_;
+		warthog::jpsplus_db* jpdb_;
+		const uint16_t* db_;
+		double preproc_time_;	
 };
 
 }
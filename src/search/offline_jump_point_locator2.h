@@ -13,68 +13,93 @@
 // @created: 05/05/2013
 //
 
+#include "gridmap.h"
 #include "jps.h"
+#include "jpsplus_db.h"
+#include "jpsplus_preproc.h"
 
 namespace warthog
 {
 
-class gridmap;
 class offline_jump_point_locator2
 {
 	public:
-		offline_jump_point_locator2(warthog::gridmap* map);
+		// the jump database is loaded from disk or, if no valid copy 
+		// exists, computed using @param nthreads threads (0 = one per core).
+		// @param progress, if given, is called as preprocessing advances.
+		offline_jump_point_locator2(warthog::gridmap* map, uint32_t nthreads = 0,
+				warthog::jpsplus_preproc::progress_fn progress = 
+				warthog::jpsplus_preproc::progress_fn());
 		~offline_jump_point_locator2();
 
 		void
 		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
+
+		// time (in microseconds) spent computing the database; 
+		// zero if the database was loaded from disk
+		inline double
+		get_preproc_time() { return preproc_time_; }
 
 		uint32_t
 		mem()
 		{
-			return sizeof(this) + sizeof(*db_)*dbsize_;
+			return sizeof(*this) + jpdb_->mem();
 		}
 
 
 	private:
 
 		void
-		preproc();
-
-		bool
-		load(const char* filename);
-
-		void 
-		save(const char* filename);
+		preproc(uint32_t nthreads, warthog::jpsplus_preproc::progress_fn progress);
 
 		void
 		jump_northwest(uint32_t node_id, uint32_t goal_id, 
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northeast(uint32_t node_id, uint32_t goal_id, 
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southwest(uint32_t node_id, uint32_t goal_id, 
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southeast(uint32_t node_id, uint32_t goal_id, 
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_north(uint32_t node_id, uint32_t goal_id, warthog::cost_t cost_to_node_id,
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_south(uint32_t node_id, uint32_t goal_id, warthog::cost_t cost_to_node_id,
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_east(uint32_t node_id, uint32_t goal_id, warthog::cost_t cost_to_node_id,
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 		void
 		jump_west(uint32_t node_id, uint32_t goal_id, warthog::cost_t cost_to_node_id,
-				std::vector<uint32_t>& neighbours, std::vector<warthog::cost_t>& costs);
+				std::vector<uint32_t>& neighbours,
+				std::vector<warthog::jps::direction>& dirs,
+				std::vector<warthog::cost_t>& costs);
 
 		warthog::gridmap* map_;
-		uint32_t dbsize_;
-		uint16_t* db_;	
+		warthog::jpsplus_db* jpdb_;
+		const uint16_t* db_;
+		double preproc_time_;	
 };
 
 }
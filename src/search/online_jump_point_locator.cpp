@@ -1,47 +1,22 @@
 #include "gridmap.h"
 #include "jps.h"
+#include "jump_scan.h"
 #include "online_jump_point_locator.h"
 
 #include <cassert>
 #include <climits>
 
 warthog::online_jump_point_locator::online_jump_point_locator(warthog::gridmap* map)
-	: map_(map), jumplimit_(UINT32_MAX)
+	: map_(map), jumplimit_(UINT32_MAX), 
+	scan_(warthog::jump_scan::get_kernel())
 {
-	rmap_ = create_rmap();
+	rmap_ = map_->rotated();
 }
 
 warthog::online_jump_point_locator::~online_jump_point_locator()
 {
-	delete rmap_;
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::gridmap*
-warthog::online_jump_point_locator::create_rmap()
-{
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
-}
-
-
 // Finds a jump point successor of node (x, y) in Direction d.
 // Also given is the location of the goal node (goalx, goaly) for a particular
 // search instance. If encountered, the goal node is always returned as a 
@@ -84,6 +59,32 @@ warthog::online_jump_point_locator::jump(warthog::jps::direction d,
 	}
 }
 
+// as ::jump, but diagonal jumps take a single step at a time
+void
+warthog::online_jump_point_locator::jump_stepwise(warthog::jps::direction d,
+	   	uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
+		warthog::cost_t& jumpcost)
+{
+	switch(d)
+	{
+		case warthog::jps::NORTHEAST:
+			stepwise_northeast(node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		case warthog::jps::NORTHWEST:
+			stepwise_northwest(node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		case warthog::jps::SOUTHEAST:
+			stepwise_southeast(node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		case warthog::jps::SOUTHWEST:
+			stepwise_southwest(node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		default:
+			jump(d, node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+	}
+}
+
 void
 warthog::online_jump_point_locator::jump_north(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
@@ -137,45 +138,11 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
-	jumpnode_id = node_id;
-
-	uint32_t neis[3] = {0, 0, 0};
+	// scan three adjacent rows, many tiles at a time, for the first
+	// forced neighbour or dead-end tile (see jump_scan.h)
 	bool deadend = false;
-
-	jumpnode_id = node_id;
-	while(true)
-	{
-		// read in tiles from 3 adjacent rows. the curent node 
-		// is in the low byte of the middle row
-		mymap->get_neighbours_32bit(jumpnode_id, neis);
-
-		// identity forced neighbours and deadend tiles. 
-		// forced neighbours are found in the top or bottom row. they 
-		// can be identified as a non-obstacle tile that follows
-		// immediately  after an obstacle tile. A dead-end tile is
-		// an obstacle found  on the middle row; 
-		uint32_t 
-		forced_bits = (~neis[0] << 1) & neis[0];
-		forced_bits |= (~neis[2] << 1) & neis[2];
-		uint32_t 
-		deadend_bits = ~neis[1];
-
-		// stop if we found any forced or dead-end tiles
-		int stop_bits = (forced_bits | deadend_bits);
-		if(stop_bits)
-		{
-			uint32_t stop_pos = __builtin_ffs(stop_bits)-1; // returns idx+1
-			jumpnode_id += stop_pos; 
-			deadend = deadend_bits & (1 << stop_pos);
-			break;
-		}
-
-		// jump to the last position in the cache. we do not jump past the end
-		// in case the last tile from the row above or below is an obstacle.
-		// Such a tile, followed by a non-obstacle tile, would yield a forced 
-		// neighbour that we don't want to miss.
-		jumpnode_id += 31;
-	}
+	jumpnode_id = node_id + scan_.east_(mymap->get_words64(), 
+			mymap->width(), node_id, deadend);
 
 	uint32_t num_steps = jumpnode_id - node_id;
 	uint32_t goal_dist = goal_id - node_id;
@@ -188,9 +155,8 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 
 	if(deadend)
 	{
-		// number of steps to reach the deadend tile is not
-		// correct here since we just inverted neis[1] and then
-		// looked for the first set bit. need -1 to fix it.
+		// the dead-end tile is an obstacle; the jump ends one
+		// step before it. need -1 to fix it.
 		num_steps -= (1 && num_steps);
 		jumpnode_id = warthog::INF;
 	}
@@ -211,37 +177,10 @@ warthog::online_jump_point_locator::__jump_west(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
+	// as per ::__jump_east
 	bool deadend = false;
-	uint32_t neis[3] = {0, 0, 0};
-
-	jumpnode_id = node_id;
-	while(true)
-	{
-		// cache 32 tiles from three adjacent rows.
-		// current tile is in the high byte of the middle row
-		mymap->get_neighbours_upper_32bit(jumpnode_id, neis);
-
-		// identify forced and dead-end nodes
-		uint32_t 
-		forced_bits = (~neis[0] >> 1) & neis[0];
-		forced_bits |= (~neis[2] >> 1) & neis[2];
-		uint32_t 
-		deadend_bits = ~neis[1];
-
-		// stop if we encounter any forced or deadend nodes
-		uint32_t stop_bits = (forced_bits | deadend_bits);
-		if(stop_bits)
-		{
-			uint32_t stop_pos = __builtin_clz(stop_bits);
-			jumpnode_id -= stop_pos;
-			deadend = deadend_bits & (0x80000000 >> stop_pos);
-			break;
-		}
-		// jump to the end of cache. jumping +32 involves checking
-		// for forced neis between adjacent sets of contiguous tiles
-		jumpnode_id -= 31;
-	
-	}
+	jumpnode_id = node_id - scan_.west_(mymap->get_words64(), 
+			mymap->width(), node_id, deadend);
 
 	uint32_t num_steps = node_id - jumpnode_id;
 	uint32_t goal_dist = node_id - goal_id;
@@ -254,18 +193,117 @@ warthog::online_jump_point_locator::__jump_west(uint32_t node_id,
 
 	if(deadend)
 	{
-		// number of steps to reach the deadend tile is not
-		// correct here since we just inverted neis[1] and then
-		// counted leading zeroes. need -1 to fix it.
+		// the dead-end tile is an obstacle; the jump ends one
+		// step before it. need -1 to fix it.
 		num_steps -= (1 && num_steps);
 		jumpnode_id = warthog::INF;
 	}
 	jumpcost = num_steps * warthog::ONE;
 }
 
+// Diagonal jumps. At every diagonal step the locator jumps straight, in 
+// both directions the diagonal is made of; the diagonal jump stops at the
+// first tile where either straight jump finds a jump point (or the goal)
+// and fails where either cannot take a single step (corner cutting, or 
+// the tile is an obstacle).
+//
+// The straight jumps are evaluated by a pair of ::diagonal_rays, one on 
+// map_ and one on rmap_ (where diagonals are diagonals too). See 
+// ::stepwise_northeast etc for the original, one step at a time, version.
 void
 warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+{
+	// early return if the first diagonal step is invalid
+	uint32_t neis;
+	map_->get_neighbours(node_id, (uint8_t*)&neis);
+	if((neis & 1542) != 1542)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
+
+	// north is east on rmap_; moving northeast moves south on rmap_
+	warthog::jump_scan::diagonal_rays<true> vertical(
+			rmap_, scan_.east_next_, map_id_to_rmap_id(node_id), true,
+			map_id_to_rmap_id(goal_id));
+	warthog::jump_scan::diagonal_rays<true> horizontal(
+			map_, scan_.east_next_, node_id, false, goal_id);
+	jump_diagonal(vertical, horizontal, node_id, 1 - (int32_t)map_->width(), 
+			jumpnode_id, jumpcost);
+}
+
+void
+warthog::online_jump_point_locator::jump_northwest(uint32_t node_id,
+	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+{
+	uint32_t neis;
+	map_->get_neighbours(node_id, (uint8_t*)&neis);
+	if((neis & 771) != 771)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
+
+	warthog::jump_scan::diagonal_rays<true> vertical(
+			rmap_, scan_.east_next_, map_id_to_rmap_id(node_id), false,
+			map_id_to_rmap_id(goal_id));
+	warthog::jump_scan::diagonal_rays<false> horizontal(
+			map_, scan_.west_next_, node_id, false, goal_id);
+	jump_diagonal(vertical, horizontal, node_id, -1 - (int32_t)map_->width(), 
+			jumpnode_id, jumpcost);
+}
+
+void
+warthog::online_jump_point_locator::jump_southeast(uint32_t node_id,
+	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+{
+	uint32_t neis;
+	map_->get_neighbours(node_id, (uint8_t*)&neis);
+	if((neis & 394752) != 394752)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
+
+	// south is west on rmap_
+	warthog::jump_scan::diagonal_rays<false> vertical(
+			rmap_, scan_.west_next_, map_id_to_rmap_id(node_id), true,
+			map_id_to_rmap_id(goal_id));
+	warthog::jump_scan::diagonal_rays<true> horizontal(
+			map_, scan_.east_next_, node_id, true, goal_id);
+	jump_diagonal(vertical, horizontal, node_id, 1 + (int32_t)map_->width(), 
+			jumpnode_id, jumpcost);
+}
+
+void
+warthog::online_jump_point_locator::jump_southwest(uint32_t node_id,
+	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+{
+	uint32_t neis;
+	map_->get_neighbours(node_id, (uint8_t*)&neis);
+	if((neis & 197376) != 197376)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
+
+	warthog::jump_scan::diagonal_rays<false> vertical(
+			rmap_, scan_.west_next_, map_id_to_rmap_id(node_id), false,
+			map_id_to_rmap_id(goal_id));
+	warthog::jump_scan::diagonal_rays<false> horizontal(
+			map_, scan_.west_next_, node_id, true, goal_id);
+	jump_diagonal(vertical, horizontal, node_id, (int32_t)map_->width() - 1, 
+			jumpnode_id, jumpcost);
+}
+
+void
+warthog::online_jump_point_locator::stepwise_northeast(uint32_t node_id,
+	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
 
@@ -278,7 +316,12 @@ warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 	// (validity of subsequent steps is checked by straight jump functions)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 1542) != 1542) { jumpnode_id = warthog::INF; jumpcost=0; return; }
+	if((neis & 1542) != 1542)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
 
 	// jump a single step at a time (no corner cutting)
 	uint32_t rnext_id = map_id_to_rmap_id(next_id);
@@ -308,7 +351,7 @@ warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_northwest(uint32_t node_id, 
+warthog::online_jump_point_locator::stepwise_northwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
@@ -321,7 +364,12 @@ warthog::online_jump_point_locator::jump_northwest(uint32_t node_id,
 	// early termination (invalid first step)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 771) != 771) { jumpnode_id = warthog::INF; jumpcost = 0; return; }
+	if((neis & 771) != 771)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
 
 	// jump a single step at a time (no corner cutting)
 	uint32_t rnext_id = map_id_to_rmap_id(next_id);
@@ -350,7 +398,7 @@ warthog::online_jump_point_locator::jump_northwest(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_southeast(uint32_t node_id, 
+warthog::online_jump_point_locator::stepwise_southeast(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
@@ -364,7 +412,12 @@ warthog::online_jump_point_locator::jump_southeast(uint32_t node_id,
 	// (validity of subsequent steps is checked by straight jump functions)
 	uint32_t neis;
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 394752) != 394752) { jumpnode_id = warthog::INF; jumpcost = 0; return; }
+	if((neis & 394752) != 394752)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
 
 	// jump a single step at a time (no corner cutting)
 	uint32_t rnext_id = map_id_to_rmap_id(next_id);
@@ -393,7 +446,7 @@ warthog::online_jump_point_locator::jump_southeast(uint32_t node_id,
 }
 
 void
-warthog::online_jump_point_locator::jump_southwest(uint32_t node_id, 
+warthog::online_jump_point_locator::stepwise_southwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	uint32_t num_steps = 0;
@@ -406,7 +459,12 @@ warthog::online_jump_point_locator::jump_southwest(uint32_t node_id,
 
 	// early termination (first step is invalid)
 	map_->get_neighbours(next_id, (uint8_t*)&neis);
-	if((neis & 197376) != 197376) { jumpnode_id = warthog::INF; jumpcost = 0; return; }
+	if((neis & 197376) != 197376)
+	{
+		jumpnode_id = warthog::INF;
+		jumpcost = 0;
+		return;
+	}
 
 	// jump a single step (no corner cutting)
 	uint32_t rnext_id = map_id_to_rmap_id(next_id);
@@ -10,11 +10,20 @@
 // [Harabor D. and Grastien A, 2011, 
 // Online Graph Pruning Pathfinding on Grid Maps, AAAI]
 //
+// Jumps north and south are made on a copy of the map which is rotated by
+// 90 degrees (rmap_, see gridmap::rotated). The copy is built once per map
+// and shared by every locator on that map.
+//
+// Thread safety: ::jump only reads map_ and rmap_ so a single locator can
+// serve any number of threads concurrently. Changes to the underlying map
+// (set_label) are not reflected in rmap_ and are not thread safe.
+//
 // @author: dharabor
 // @created: 03/09/2012
 //
 
 #include "jps.h"
+#include "jump_scan.h"
 #include "gridmap.h"
 
 namespace warthog
@@ -30,10 +39,18 @@ class online_jump_point_locator
 		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 
+		// as ::jump, but diagonal jumps advance one step at a time and
+		// make two full straight jumps per step (the original method).
+		// slower; kept to verify ::jump.
+		void
+		jump_stepwise(warthog::jps::direction d, uint32_t node_id, 
+				uint32_t goalid, uint32_t& jumpnode_id, 
+				warthog::cost_t& jumpcost);
+
 		uint32_t 
 		mem()
 		{
-			return sizeof(this) + rmap_->mem();
+			return sizeof(*this);
 		}
 
 	private:
@@ -50,6 +67,18 @@ class online_jump_point_locator
 		jump_southeast(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
+		stepwise_northwest(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		void
+		stepwise_northeast(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		void
+		stepwise_southwest(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		void
+		stepwise_southeast(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		void
 		jump_north(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 		void
@@ -62,6 +91,36 @@ class online_jump_point_locator
 		jump_west(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
 
+		// walk a diagonal from @param node_id, @param step at a time,
+		// until the straight jumps in @param vertical or @param 
+		// horizontal find a jump point (or are blocked)
+		template<bool V, bool H>
+		inline void
+		jump_diagonal(warthog::jump_scan::diagonal_rays<V>& vertical,
+				warthog::jump_scan::diagonal_rays<H>& horizontal,
+				uint32_t node_id, int32_t step, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
+		{
+			uint32_t num_steps = 0;
+			while(true)
+			{
+				num_steps++;
+				node_id += step;
+				uint32_t ray1 = vertical.next();
+				if(ray1 == warthog::jump_scan::RAY_JP) { break; }
+				uint32_t ray2 = horizontal.next();
+				if(ray2 == warthog::jump_scan::RAY_JP) { break; }
+				if(ray1 == warthog::jump_scan::RAY_BLOCKED || 
+						ray2 == warthog::jump_scan::RAY_BLOCKED)
+				{
+					node_id = warthog::INF;
+					break;
+				}
+			}
+			jumpnode_id = node_id;
+			jumpcost = num_steps*warthog::ROOT_TWO;
+		}
+
 		// these versions can be passed a map parameter to
 		// use when jumping. they allow switching between
 		// map_ and rmap_ (a rotated counterpart).
@@ -108,12 +167,10 @@ class online_jump_point_locator
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::gridmap*
-		create_rmap();
-
 		warthog::gridmap* map_;
-		warthog::gridmap* rmap_;
+		warthog::gridmap* rmap_; // map_->rotated(), shared
 		uint32_t jumplimit_;
+		const warthog::jump_scan::kernel& scan_; // east and west scans
 };
 
 }
@@ -1,49 +1,24 @@
 #include "gridmap.h"
 #include "jps.h"
+#include "jump_scan.h"
 #include "online_jump_point_locator2.h"
 
 #include <cassert>
 #include <climits>
 
 warthog::online_jump_point_locator2::online_jump_point_locator2(warthog::gridmap* map)
-	: map_(map), jumplimit_(UINT32_MAX)
+	: map_(map), jumplimit_(UINT32_MAX), 
+	scan_(warthog::jump_scan::get_kernel())
 {
-	rmap_ = create_rmap();
+	rmap_ = map_->rotated();
 	current_node_id_ = current_rnode_id_ = warthog::INF;
 	current_goal_id_ = current_rgoal_id_ = warthog::INF;
 }
 
 warthog::online_jump_point_locator2::~online_jump_point_locator2()
 {
-	delete rmap_;
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::gridmap*
-warthog::online_jump_point_locator2::create_rmap()
-{
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::gridmap* rmap = new warthog::gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
-}
-
-
 // Finds a jump point successor of node (x, y) in Direction d.
 // Also given is the location of the goal node (goalx, goaly) for a particular
 // search instance. If encountered, the goal node is always returned as a 
@@ -54,6 +29,7 @@ void
 warthog::online_jump_point_locator2::jump(warthog::jps::direction d,
 	   	uint32_t node_id, uint32_t goal_id, 
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	// cache node and goal ids so we don't need to convert all the time
@@ -72,28 +48,28 @@ warthog::online_jump_point_locator2::jump(warthog::jps::direction d,
 	switch(d)
 	{
 		case warthog::jps::NORTH:
-			jump_north(jpoints, costs);
+			jump_north(jpoints, dirs, costs);
 			break;
 		case warthog::jps::SOUTH:
-			jump_south(jpoints, costs);
+			jump_south(jpoints, dirs, costs);
 			break;
 		case warthog::jps::EAST:
-			jump_east(jpoints, costs);
+			jump_east(jpoints, dirs, costs);
 			break;
 		case warthog::jps::WEST:
-			jump_west(jpoints, costs);
+			jump_west(jpoints, dirs, costs);
 			break;
 		case warthog::jps::NORTHEAST:
-			jump_northeast(jpoints, costs);
+			jump_northeast(jpoints, dirs, costs);
 			break;
 		case warthog::jps::NORTHWEST:
-			jump_northwest(jpoints, costs);
+			jump_northwest(jpoints, dirs, costs);
 			break;
 		case warthog::jps::SOUTHEAST:
-			jump_southeast(jpoints, costs);
+			jump_southeast(jpoints, dirs, costs);
 			break;
 		case warthog::jps::SOUTHWEST:
-			jump_southwest(jpoints, costs);
+			jump_southwest(jpoints, dirs, costs);
 			break;
 		default:
 			break;
@@ -103,6 +79,7 @@ warthog::online_jump_point_locator2::jump(warthog::jps::direction d,
 void
 warthog::online_jump_point_locator2::jump_north(
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t rnode_id = current_rnode_id_;
@@ -115,8 +92,8 @@ warthog::online_jump_point_locator2::jump_north(
 	if(jumpnode_id != warthog::INF)
 	{
 		jumpnode_id = current_node_id_ - (jumpcost / warthog::ONE) * map_->width();
-		*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::NORTH;
 		jpoints.push_back(jumpnode_id);
+		dirs.push_back(warthog::jps::NORTH);
 		costs.push_back(jumpcost);
 	}
 }
@@ -133,7 +110,8 @@ warthog::online_jump_point_locator2::__jump_north(uint32_t node_id,
 
 void
 warthog::online_jump_point_locator2::jump_south(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t rnode_id = current_rnode_id_;
@@ -146,8 +124,8 @@ warthog::online_jump_point_locator2::jump_south(
 	if(jumpnode_id != warthog::INF)
 	{
 		jumpnode_id = current_node_id_ + (jumpcost / warthog::ONE) * map_->width();
-		*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::SOUTH;
 		jpoints.push_back(jumpnode_id);
+		dirs.push_back(warthog::jps::SOUTH);
 		costs.push_back(jumpcost);
 	}
 }
@@ -164,7 +142,8 @@ warthog::online_jump_point_locator2::__jump_south(uint32_t node_id,
 
 void
 warthog::online_jump_point_locator2::jump_east(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t node_id = current_node_id_;
@@ -176,8 +155,8 @@ warthog::online_jump_point_locator2::jump_east(
 
 	if(jumpnode_id != warthog::INF)
 	{
-		*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::EAST;
 		jpoints.push_back(jumpnode_id);
+		dirs.push_back(warthog::jps::EAST);
 		costs.push_back(jumpcost);
 	}
 }
@@ -188,45 +167,11 @@ warthog::online_jump_point_locator2::__jump_east(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
-	jumpnode_id = node_id;
-
-	uint32_t neis[3] = {0, 0, 0};
+	// scan three adjacent rows, many tiles at a time, for the first
+	// forced neighbour or dead-end tile (see jump_scan.h)
 	bool deadend = false;
-
-	jumpnode_id = node_id;
-	while(true)
-	{
-		// read in tiles from 3 adjacent rows. the curent node 
-		// is in the low byte of the middle row
-		mymap->get_neighbours_32bit(jumpnode_id, neis);
-
-		// identity forced neighbours and deadend tiles. 
-		// forced neighbours are found in the top or bottom row. they 
-		// can be identified as a non-obstacle tile that follows
-		// immediately  after an obstacle tile. A dead-end tile is
-		// an obstacle found  on the middle row; 
-		uint32_t 
-		forced_bits = (~neis[0] << 1) & neis[0];
-		forced_bits |= (~neis[2] << 1) & neis[2];
-		uint32_t 
-		deadend_bits = ~neis[1];
-
-		// stop if we found any forced or dead-end tiles
-		int stop_bits = (forced_bits | deadend_bits);
-		if(stop_bits)
-		{
-			uint32_t stop_pos = __builtin_ffs(stop_bits)-1; // returns idx+1
-			jumpnode_id += stop_pos; 
-			deadend = deadend_bits & (1 << stop_pos);
-			break;
-		}
-
-		// jump to the last position in the cache. we do not jump past the end
-		// in case the last tile from the row above or below is an obstacle.
-		// Such a tile, followed by a non-obstacle tile, would yield a forced 
-		// neighbour that we don't want to miss.
-		jumpnode_id += 31;
-	}
+	jumpnode_id = node_id + scan_.east_(mymap->get_words64(), 
+			mymap->width(), node_id, deadend);
 
 	uint32_t num_steps = jumpnode_id - node_id;
 	uint32_t goal_dist = goal_id - node_id;
@@ -239,9 +184,8 @@ warthog::online_jump_point_locator2::__jump_east(uint32_t node_id,
 
 	if(deadend)
 	{
-		// number of steps to reach the deadend tile is not
-		// correct here since we just inverted neis[1] and then
-		// looked for the first set bit. need -1 to fix it.
+		// the dead-end tile is an obstacle; the jump ends one
+		// step before it. need -1 to fix it.
 		num_steps -= (1 && num_steps);
 		jumpnode_id = warthog::INF;
 	}
@@ -252,7 +196,8 @@ warthog::online_jump_point_locator2::__jump_east(uint32_t node_id,
 // analogous to ::jump_east 
 void
 warthog::online_jump_point_locator2::jump_west(
-		std::vector<uint32_t>& jpoints, 
+		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t node_id = current_node_id_;
@@ -264,8 +209,8 @@ warthog::online_jump_point_locator2::jump_west(
 
 	if(jumpnode_id != warthog::INF)
 	{
-		*(((uint8_t*)&jumpnode_id)+3) = warthog::jps::WEST;
 		jpoints.push_back(jumpnode_id);
+		dirs.push_back(warthog::jps::WEST);
 		costs.push_back(jumpcost);
 	}
 }
@@ -275,37 +220,10 @@ warthog::online_jump_point_locator2::__jump_west(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::gridmap* mymap)
 {
+	// as per ::__jump_east
 	bool deadend = false;
-	uint32_t neis[3] = {0, 0, 0};
-
-	jumpnode_id = node_id;
-	while(true)
-	{
-		// cache 32 tiles from three adjacent rows.
-		// current tile is in the high byte of the middle row
-		mymap->get_neighbours_upper_32bit(jumpnode_id, neis);
-
-		// identify forced and dead-end nodes
-		uint32_t 
-		forced_bits = (~neis[0] >> 1) & neis[0];
-		forced_bits |= (~neis[2] >> 1) & neis[2];
-		uint32_t 
-		deadend_bits = ~neis[1];
-
-		// stop if we encounter any forced or deadend nodes
-		uint32_t stop_bits = (forced_bits | deadend_bits);
-		if(stop_bits)
-		{
-			uint32_t stop_pos = __builtin_clz(stop_bits);
-			jumpnode_id -= stop_pos;
-			deadend = deadend_bits & (0x80000000 >> stop_pos);
-			break;
-		}
-		// jump to the end of cache. jumping +32 involves checking
-		// for forced neis between adjacent sets of contiguous tiles
-		jumpnode_id -= 31;
-	
-	}
+	jumpnode_id = node_id - scan_.west_(mymap->get_words64(), 
+			mymap->width(), node_id, deadend);
 
 	uint32_t num_steps = node_id - jumpnode_id;
 	uint32_t goal_dist = node_id - goal_id;
@@ -318,9 +236,8 @@ warthog::online_jump_point_locator2::__jump_west(uint32_t node_id,
 
 	if(deadend)
 	{
-		// number of steps to reach the deadend tile is not
-		// correct here since we just inverted neis[1] and then
-		// counted leading zeroes. need -1 to fix it.
+		// the dead-end tile is an obstacle; the jump ends one
+		// step before it. need -1 to fix it.
 		num_steps -= (1 && num_steps);
 		jumpnode_id = warthog::INF;
 	}
@@ -330,6 +247,7 @@ warthog::online_jump_point_locator2::__jump_west(uint32_t node_id,
 void
 warthog::online_jump_point_locator2::jump_northeast(
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t jumpnode_id, jp1_id, jp2_id;
@@ -362,16 +280,16 @@ warthog::online_jump_point_locator2::jump_northeast(
 		if(jp1_id != warthog::INF)
 		{
 			jp1_id = node_id - (jp1_cost / warthog::ONE) * map_->width();
-			*(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
 			jpoints.push_back(jp1_id);
+			dirs.push_back(warthog::jps::NORTH);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
 		if(jp2_id != warthog::INF)
 		{
-			*(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
 			jpoints.push_back(jp2_id);
+			dirs.push_back(warthog::jps::EAST);
 			costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
 			if(jp1_cost == 0) { break; } // no corner cutting
 		}
@@ -420,6 +338,7 @@ warthog::online_jump_point_locator2::__jump_northeast(
 void
 warthog::online_jump_point_locator2::jump_northwest(
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t jumpnode_id, jp1_id, jp2_id;
@@ -452,16 +371,16 @@ warthog::online_jump_point_locator2::jump_northwest(
 		if(jp1_id != warthog::INF)
 		{
 			jp1_id = node_id - (jp1_cost / warthog::ONE) * map_->width();
-			*(((uint8_t*)&jp1_id)+3) = warthog::jps::NORTH;
 			jpoints.push_back(jp1_id);
+			dirs.push_back(warthog::jps::NORTH);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
 		if(jp2_id != warthog::INF)
 		{
-			*(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
 			jpoints.push_back(jp2_id);
+			dirs.push_back(warthog::jps::WEST);
 			costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
 			if(jp1_cost == 0) { break; } // no corner cutting
 		}
@@ -510,6 +429,7 @@ warthog::online_jump_point_locator2::__jump_northwest(
 void
 warthog::online_jump_point_locator2::jump_southeast(
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t jumpnode_id, jp1_id, jp2_id;
@@ -542,16 +462,16 @@ warthog::online_jump_point_locator2::jump_southeast(
 		if(jp1_id != warthog::INF)
 		{
 			jp1_id = node_id + (jp1_cost / warthog::ONE) * map_->width();
-			*(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
 			jpoints.push_back(jp1_id);
+			dirs.push_back(warthog::jps::SOUTH);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; } // no corner cutting
 		}
 
 		if(jp2_id != warthog::INF)
 		{
-			*(((uint8_t*)&jp2_id)+3) = warthog::jps::EAST;
 			jpoints.push_back(jp2_id);
+			dirs.push_back(warthog::jps::EAST);
 			costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
 			if(jp1_cost == 0) { break; } // no corner cutting
 		}
@@ -600,6 +520,7 @@ warthog::online_jump_point_locator2::__jump_southeast(
 void
 warthog::online_jump_point_locator2::jump_southwest(
 		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::jps::direction>& dirs,
 		std::vector<warthog::cost_t>& costs)
 {
 	uint32_t jumpnode_id, jp1_id, jp2_id;
@@ -631,16 +552,16 @@ warthog::online_jump_point_locator2::jump_southwest(
 		if(jp1_id != warthog::INF)
 		{
 			jp1_id = node_id + (jp1_cost / warthog::ONE) * map_->width();
-			*(((uint8_t*)&jp1_id)+3) = warthog::jps::SOUTH;
 			jpoints.push_back(jp1_id);
+			dirs.push_back(warthog::jps::SOUTH);
 			costs.push_back(cost_to_nodeid + jumpcost + jp1_cost);
 			if(jp2_cost == 0) { break; }
 		}
 
 		if(jp2_id != warthog::INF)
 		{
-			*(((uint8_t*)&jp2_id)+3) = warthog::jps::WEST;
 			jpoints.push_back(jp2_id);
+			dirs.push_back(warthog::jps::WEST);
 			costs.push_back(cost_to_nodeid + jumpcost + jp2_cost);
 			if(jp1_cost == 0) { break; }
 		}
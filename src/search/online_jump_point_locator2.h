@@ -10,11 +10,15 @@
 // [Harabor D. and Grastien A, 2011, 
 // Online Graph Pruning Pathfinding on Grid Maps, AAAI]
 //
+// Thread safety: NOT thread safe. ::jump caches intermediate results in
+// member variables; use one instance per thread.
+//
 // @author: dharabor
 // @created: 03/09/2012
 //
 
 #include "jps.h"
+#include "jump_scan.h"
 
 //class warthog::gridmap;
 namespace warthog
@@ -29,46 +33,55 @@ class online_jump_point_locator2
 		void
 		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
 				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 
 		uint32_t 
 		mem()
 		{
-			return sizeof(this) + rmap_->mem();
+			return sizeof(*this);
 		}
 
 	private:
 		void
 		jump_north(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_south(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_east(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_west(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_northwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southeast(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 		void
 		jump_southwest(
-				std::vector<uint32_t>& jpoints, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::jps::direction>& dirs,
 				std::vector<warthog::cost_t>& costs);
 
 		// these versions can be passed a map parameter to
@@ -151,12 +164,10 @@ class online_jump_point_locator2
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::gridmap*
-		create_rmap();
-
 		warthog::gridmap* map_;
-		warthog::gridmap* rmap_;
+		warthog::gridmap* rmap_; // map_->rotated(), shared
 		uint32_t jumplimit_;
+		const warthog::jump_scan::kernel& scan_; // east and west scans
 
 		uint32_t current_goal_id_;
 		uint32_t current_rgoal_id_;
@@ -9,40 +9,13 @@
 warthog::online_jump_point_locator_wgm::online_jump_point_locator_wgm(
         warthog::weighted_gridmap* map) : map_(map), jumplimit_(UINT32_MAX)
 {
-	rmap_ = create_rmap();
+	rmap_ = map_->rotated();
 }
 
 warthog::online_jump_point_locator_wgm::~online_jump_point_locator_wgm()
 {
-	delete rmap_;
 }
 
-// create a copy of the grid map which is rotated by 90 degrees clockwise.
-// this version will be used when jumping North or South. 
-warthog::weighted_gridmap*
-warthog::online_jump_point_locator_wgm::create_rmap()
-{
-	uint32_t maph = map_->header_height();
-	uint32_t mapw = map_->header_width();
-	uint32_t rmaph = mapw;
-	uint32_t rmapw = maph;
-	warthog::weighted_gridmap* rmap = new warthog::weighted_gridmap(rmaph, rmapw);
-
-	for(uint32_t x = 0; x < mapw; x++) 
-	{
-		for(uint32_t y = 0; y < maph; y++)
-		{
-			uint32_t label = map_->get_label(map_->to_padded_id(x, y));
-			uint32_t rx = ((rmapw-1) - y);
-			uint32_t ry = x;
-			uint32_t rid = rmap->to_padded_id(rx, ry);
-			rmap->set_label(rid, label);
-		}
-	}
-	return rmap;
-}
-
-
 // Finds a jump point successor of node (x, y) in Direction d.
 // Also given is the location of the goal node (goalx, goaly) for a particular
 // search instance. If encountered, the goal node is always returned as a 
@@ -139,7 +112,7 @@ warthog::online_jump_point_locator_wgm::__jump_east(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::weighted_gridmap* mymap)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 
     // scan ahead for obstacles or changes in terrain
     warthog::dbword* next_label = mymap->get_label_ptr(node_id);
@@ -211,7 +184,7 @@ warthog::online_jump_point_locator_wgm::__jump_west(uint32_t node_id,
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 		warthog::weighted_gridmap* mymap)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 
     // scan ahead for obstacles or changes in terrain
     warthog::dbword* next_label = mymap->get_label_ptr(node_id);
@@ -275,7 +248,7 @@ void
 warthog::online_jump_point_locator_wgm::jump_northeast(uint32_t node_id,
 	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 	uint32_t next_id = node_id;
     uint32_t tile_ids[9];
     warthog::dbword tiles[9];
@@ -323,7 +296,7 @@ void
 warthog::online_jump_point_locator_wgm::jump_northwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 	uint32_t next_id = node_id;
     uint32_t tile_ids[9];
     warthog::dbword tiles[9];
@@ -377,7 +350,7 @@ void
 warthog::online_jump_point_locator_wgm::jump_southeast(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 	uint32_t next_id = node_id;
     uint32_t tile_ids[9];
     warthog::dbword tiles[9];
@@ -426,7 +399,7 @@ void
 warthog::online_jump_point_locator_wgm::jump_southwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-    uint32_t rawjumpcost = 0;
+    warthog::cost_t rawjumpcost = 0;
 	uint32_t next_id = node_id;
     uint32_t tile_ids[9];
     warthog::dbword tiles[9];
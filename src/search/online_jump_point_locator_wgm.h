@@ -30,7 +30,7 @@ class online_jump_point_locator_wgm
 		uint32_t 
 		mem()
 		{
-			return sizeof(this) + rmap_->mem();
+			return sizeof(*this);
 		}
 
 	private:
@@ -105,11 +105,8 @@ class online_jump_point_locator_wgm
 			return map_->to_padded_id(x, y);
 		}
 
-		warthog::weighted_gridmap*
-		create_rmap();
-
 		warthog::weighted_gridmap* map_;
-		warthog::weighted_gridmap* rmap_;
+		warthog::weighted_gridmap* rmap_; // map_->rotated(), shared
 		uint32_t jumplimit_;
 };
 
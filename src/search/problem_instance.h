@@ -13,16 +13,16 @@ class problem_instance
 		~problem_instance() { } 
 
 		inline void
-		set_goal(uint32_t goal_id) { goal_ = goal_id; }
+		set_goal(warthog::sn_id_t goal_id) { goal_ = goal_id; }
 
-		inline uint32_t
+		inline warthog::sn_id_t
 		get_goal() { return goal_; }
 
-		inline uint32_t
+		inline warthog::sn_id_t
 		get_start() { return start_; }
 
 		inline void
-		set_start(uint32_t start_id) { start_ = start_id; }
+		set_start(warthog::sn_id_t start_id) { start_ = start_id; }
 
 		inline uint32_t
 		get_searchid() { return search_id_; } 
@@ -31,8 +31,8 @@ class problem_instance
 		set_searchid(uint32_t search_id) { search_id_ = search_id; }
 
 	private:
-		uint32_t goal_;
-		uint32_t start_;
+		warthog::sn_id_t goal_;
+		warthog::sn_id_t start_;
 		uint32_t search_id_;
 
 		// no copy
@@ -3,6 +3,27 @@
 
 // search_node.h
 //
+// By default each node stores its f-value, g-value, a pointer to its parent
+// and the id of the search in which it was last reset (32 bytes on 64 bit
+// platforms). 
+//
+// Compiling with WARTHOG_COMPACT_NODES selects a 16 byte layout instead:
+// parents are referred to by id rather than pointer, the searchid is 
+// dropped and f-values are not stored at all. The open list keeps f 
+// (see warthog::dary_heap) and a node whose g-value decreases has its 
+// f-value adjusted by the same amount. get_f, set_f, get_parent, 
+// get_searchid and the comparison operators are unavailable in this mode; 
+// use get_parent_id to follow backpointers.
+//
+// Node ids are of type warthog::sn_id_t (see constants.h). Bit 0 of 
+// id_and_status_ is the expansion status and the remaining bits store the 
+// id, so up to 2^31 (resp. 2^63) distinct ids are available. The direction
+// of the parent (used by JPS) is stored separately: in its own byte, which 
+// occupies padding of the default layout, or, for compact nodes, in the 
+// top byte of priority_. This limits the open list to 2^24-1 elements; 
+// warthog::dary_heap aborts if it grows any larger.
+// 64 bit ids and 64 bit costs (see constants.h) enlarge both layouts.
+//
 // @author: dharabor
 // @created: 10/08/2012
 //
@@ -11,34 +32,61 @@
 #include "cpool.h"
 #include "jps.h"
 
+#include <atomic>
 #include <iostream>
 
 namespace warthog
 {
 	
-const uint32_t NODEID_AND_STATUS_MASK = (1 << 24) - 1;
-const uint32_t STATUS_MASK = 1;
+const warthog::sn_id_t STATUS_MASK = 1;
+#ifdef WARTHOG_COMPACT_NODES
+const uint32_t PRIORITY_MASK = (1 << 24) - 1;
+#endif
+
 class search_node
 {
 	public:
-		search_node(uint32_t id) 
-			: id_and_status_(id << 1), f_(warthog::INF), g_(warthog::INF), parent_(0), 
+#ifdef WARTHOG_COMPACT_NODES
+		search_node(warthog::sn_id_t id) 
+			: g_(warthog::COST_MAX), id_and_status_(id << 1), 
+			parent_id_(warthog::INF), priority_(PRIORITY_MASK)
+#else
+		search_node(warthog::sn_id_t id) 
+			: f_(warthog::COST_MAX), g_(warthog::COST_MAX), 
+			id_and_status_(id << 1), pdir_(warthog::jps::NONE), parent_(0), 
 			priority_(warthog::INF), searchid_(0)
+#endif
 		{
-			assert(this->get_id() < ((1ul<<31)-1));
+			assert(this->get_id() == id);
+			#ifndef NDEBUG
 			refcount_++;
+			#endif
 		}
 
 		~search_node()
 		{
+			#ifndef NDEBUG
 			refcount_--;
+			#endif
 		}
 
+#ifdef WARTHOG_COMPACT_NODES
+		// NB: compact nodes do not record the searchid
+		inline void
+		reset(uint32_t)
+		{
+			id_and_status_ &= ~1;
+			g_ = warthog::COST_MAX;
+			parent_id_ = warthog::INF;
+			priority_ = PRIORITY_MASK; // also resets pdir
+			assert(get_pdir () == 0);
+		}
+#else
 		inline void
 		reset(uint32_t searchid)
 		{
 			id_and_status_ &= ~1;
-			f_ = g_ = warthog::INF;
+			f_ = g_ = warthog::COST_MAX;
 			parent_ = 0;
 			priority_ = warthog::INF;
 			set_pdir(warthog::jps::NONE);
@@ -57,30 +105,43 @@ class search_node
 		{
 			searchid_ = searchid;
 		}
+#endif
 
-		inline uint32_t 
-		get_id() const { return (id_and_status_ & NODEID_AND_STATUS_MASK) >> 1; }
+		inline warthog::sn_id_t 
+		get_id() const { return id_and_status_ >> 1; }
 
 		inline void
-		set_id(uint32_t id) 
+		set_id(warthog::sn_id_t id) 
 		{ 
-			id = ((id << 1) | (id_and_status_ & 1)) & NODEID_AND_STATUS_MASK;
-			id_and_status_ |= id;
+			id_and_status_ = (id << 1) | (id_and_status_ & STATUS_MASK);
 		} 
 
+#ifdef WARTHOG_COMPACT_NODES
 		inline warthog::jps::direction
 		get_pdir() const
 		{
-			return (warthog::jps::direction)
-			   	*(((uint8_t*)(&id_and_status_))+3);
+			return (warthog::jps::direction)(priority_ >> 24);
 		}
 
 		inline void
 		set_pdir(warthog::jps::direction d)
 		{
-			*(((uint8_t*)(&id_and_status_))+3) = d;
+			priority_ = (priority_ & PRIORITY_MASK) | ((uint32_t)d << 24);
+		}
+#else
+		inline warthog::jps::direction
+		get_pdir() const
+		{
+			return (warthog::jps::direction)pdir_;
 		}
 
+		inline void
+		set_pdir(warthog::jps::direction d)
+		{
+			pdir_ = d;
+		}
+#endif
+
 		inline bool
 		get_expanded() const { return (id_and_status_ & STATUS_MASK); }
 
@@ -88,20 +149,51 @@ class search_node
 		set_expanded(bool expanded) 
 		{ 
 			id_and_status_ &= ~STATUS_MASK; // reset bit0
-			id_and_status_ ^= (uint32_t)(expanded?1:0); // set it anew
+			id_and_status_ ^= (warthog::sn_id_t)(expanded?1:0); // set it anew
 		}
 
+#ifdef WARTHOG_COMPACT_NODES
+		// @return the id of the parent node or warthog::INF if there is none
+		inline warthog::sn_id_t
+		get_parent_id() const { return parent_id_; }
+
+		inline void
+		set_parent(warthog::search_node* parent) 
+		{ 
+			parent_id_ = parent ? parent->get_id() : warthog::INF; 
+		} 
+#else
 		inline warthog::search_node* 
 		get_parent() const { return parent_; }
 
+		// @return the id of the parent node or warthog::INF if there is none
+		inline warthog::sn_id_t
+		get_parent_id() const 
+		{ 
+			return parent_ ? parent_->get_id() : warthog::INF; 
+		}
+
 		inline void
 		set_parent(warthog::search_node* parent) { parent_ = parent; } 
+#endif
 
+#ifdef WARTHOG_COMPACT_NODES
+		inline uint32_t
+		get_priority() const { return priority_ & PRIORITY_MASK; }
+
+		inline void
+		set_priority(uint32_t priority) 
+		{ 
+			assert(priority < PRIORITY_MASK);
+			priority_ = (priority_ & ~PRIORITY_MASK) | priority; 
+		} 
+#else
 		inline uint32_t
 		get_priority() const { return priority_; }
 
 		inline void
 		set_priority(uint32_t priority) { priority_ = priority; } 
+#endif
 
 		inline warthog::cost_t
 		get_g() const { return g_; }
@@ -109,6 +201,23 @@ class search_node
 		inline void
 		set_g(warthog::cost_t g) { g_ = g; }
 
+#ifdef WARTHOG_COMPACT_NODES
+		inline void 
+		relax(warthog::cost_t g, warthog::search_node* parent)
+		{
+			assert(g < g_);
+			g_ = g;
+			parent_id_ = parent->get_id();
+		}
+
+		inline void 
+		print(std::ostream&  out) const
+		{
+			out << "search_node id:" << get_id() << " g: "<<g_ / (double)warthog::ONE
+				<< " expanded: " << get_expanded() << " " 
+				<< " pdir: "<< get_pdir() << " ";
+		}
+#else
 		inline warthog::cost_t 
 		get_f() const { return f_; }
 
@@ -210,7 +319,10 @@ class search_node
 				<< " expanded: " << get_expanded() << " " 
 				<< " pdir: "<< get_pdir() << " ";
 		}
+#endif
 
+		// number of live nodes; maintained only in debug builds (the 
+		// shared counter would otherwise be contended by concurrent searches)
 		static uint32_t 
 		get_refcount() { return refcount_; }
 
@@ -221,14 +333,23 @@ class search_node
 		}
 
 	private:
-		uint32_t id_and_status_; // bit 0 is expansion status; 1-31 are id
+		// costs first; 64 bit costs then need no padding
+#ifdef WARTHOG_COMPACT_NODES
+		warthog::cost_t g_;
+		warthog::sn_id_t id_and_status_; // bit 0 is expansion status
+		warthog::sn_id_t parent_id_;
+		uint32_t priority_; // bits 0-23: expansion priority; 24-31: pdir
+#else
 		warthog::cost_t f_;
 		warthog::cost_t g_;
+		warthog::sn_id_t id_and_status_; // bit 0 is expansion status
+		uint8_t pdir_;
 		warthog::search_node* parent_;
 		uint32_t priority_; // expansion priority
 		uint32_t searchid_;
+#endif
 
-		static uint32_t refcount_;
+		static std::atomic<uint32_t> refcount_;
 };
 
 }
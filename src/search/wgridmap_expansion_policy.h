@@ -33,6 +33,14 @@ class wgridmap_expansion_policy
 			return n;
 		}
 
+		// @return the node with the given id or null if it has not been
+		// generated since the last call to ::clear
+		inline warthog::search_node*
+		find(warthog::sn_id_t node_id)
+		{
+			return nodepool_->find(node_id);
+		}
+
 		inline void
 		clear()
 		{
@@ -49,7 +57,7 @@ class wgridmap_expansion_policy
 			for(int i=0; i < 10; i++)
 			{
 				neis_[i] = 0;
-				costs_[i] = warthog::INF;
+				costs_[i] = warthog::COST_MAX;
 			}
 		}
 
@@ -113,6 +121,21 @@ class wgridmap_expansion_policy
 			return map_->width();
 		}
 
+		// the (padded) coordinates of node @param id
+		inline void
+		get_xy(warthog::sn_id_t id, uint32_t& x, uint32_t& y)
+		{
+			map_->to_padded_xy(id, x, y);
+		}
+
+		// @return the id of the node @param dx columns east and @param dy 
+		// rows south of node @param id (dx and dy are -1, 0 or 1)
+		inline warthog::sn_id_t
+		get_neighbour_id(warthog::sn_id_t id, int32_t dx, int32_t dy)
+		{
+			return map_->get_neighbour_id(id, dx, dy);
+		}
+
 	private:
 		warthog::weighted_gridmap* map_;
 		warthog::blocklist* nodepool_;
@@ -1,18 +1,30 @@
 #include "blockmap.h"
+#include "component_index.h"
+#include "cpd.h"
 #include "cuckoo_table.h"
 #include "cpool.h"
+#include "dary_heap.h"
+#include "dstar_lite.h"
 #include "flexible_astar.h"
+#include "goal_bounding.h"
 #include "gridmap.h"
 #include "gridmap_expansion_policy.h"
 #include "hash_table.h"
 #include "jps_expansion_policy.h"
+#include "jump_scan.h"
+#include "jpsplus_preproc.h"
+#include "landmark_heuristic.h"
+#include "online_jump_point_locator.h"
 #include "pqueue.h"
 #include "octile_heuristic.h"
 #include "search_node.h"
 #include "scenario_manager.h"
+#include "timer.h"
+#include "weighted_gridmap.h"
 
 #include "getopt.h"
 
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <tr1/unordered_map>
@@ -21,6 +33,7 @@
 void blockmap_access_test();
 void gridmap_access_test();
 void pqueue_insert_test();
+void dary_heap_test();
 void cuckoo_table_test();
 void unordered_map_test();
 void hash_table_test();
@@ -28,10 +41,35 @@ void gridmap_expansion_policy_test();
 void flexible_astar_test();
 void test_alloc();
 void online_jps_test();
+void jpsplus_preproc_test(const char* mapfile);
+void dstar_lite_test(const char* scenfile);
+void time_sliced_test(const char* scenfile);
+void component_index_test(const char* mapfile);
+void cpd_test(const char* mapfile);
+void landmark_heuristic_test(const char* mapfile);
+void goal_bounding_test(const char* mapfile);
+void gridmap_word_test(const char* mapfile);
+void jump_scan_test(const char* mapfile);
+void diagonal_jump_test(const char* mapfile);
+void rotated_map_test(const char* mapfile);
+void blockmap_test(const char* mapfile);
 
 int main(int argc, char** argv)
 {
 	//flexible_astar_test();
+	//dary_heap_test();
+	//jpsplus_preproc_test("orz700d.map");
+	//dstar_lite_test("orz700d.map.scen");
+	//time_sliced_test("orz700d.map.scen");
+	//component_index_test("orz700d.map");
+	//cpd_test("arena.map");
+	//landmark_heuristic_test("16room_000.map");
+	//goal_bounding_test("den401d.map");
+	//gridmap_word_test("AR0044SR.map");
+	//jump_scan_test("AR0044SR.map");
+	//diagonal_jump_test("AR0044SR.map");
+	//rotated_map_test("AR0044SR.map");
+	//blockmap_test("AR0044SR.map");
 	online_jps_test();
 }
 
@@ -154,6 +192,197 @@ void online_jps_test()
 
 }
 
+// the sweep-based builder must produce exactly the same
+// jump labels as the (reference) online builder
+void jpsplus_preproc_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	uint32_t dbsize = 8*map.padded_mapsize();
+	uint16_t* online = new uint16_t[dbsize];
+	uint16_t* sweep = new uint16_t[dbsize];
+	for(uint32_t i = 0; i < dbsize; i++) { online[i] = sweep[i] = 0; }
+
+	warthog::timer mytimer;
+	mytimer.start();
+	warthog::jpsplus_preproc::compute_labels_online(&map, online, 1, 0);
+	mytimer.stop();
+	double online_time = mytimer.elapsed_time_micro();
+
+	mytimer.start();
+	warthog::jpsplus_preproc::compute_labels(&map, sweep, 0, 0);
+	mytimer.stop();
+	double sweep_time = mytimer.elapsed_time_micro();
+
+	for(uint32_t i = 0; i < dbsize; i++)
+	{
+		if(online[i] != sweep[i])
+		{
+			std::cerr << "label mismatch! node " << i/8 << " dir " << i%8
+				<< " online: " << online[i] << " sweep: " << sweep[i] 
+				<< std::endl;
+			exit(1);
+		}
+	}
+	std::cerr << "labels identical. online: " << online_time 
+		<< "us sweep: " << sweep_time << "us\n";
+	delete [] online;
+	delete [] sweep;
+}
+
+// an agent follows its path and, one third of the way along, a few tiles
+// ahead of it are blocked (then unblocked at two thirds). each replan by
+// D* Lite must be as short as a path computed from scratch by A*.
+void dstar_lite_test(const char* scenfile)
+{
+	warthog::scenario_manager scenmgr;
+	scenmgr.load_scenario(scenfile);
+	warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+	warthog::gridmap_expansion_policy d_expander(&map);
+	warthog::gridmap_expansion_policy a_expander(&map);
+	warthog::dstar_lite<
+		warthog::octile_heuristic,
+		warthog::gridmap_expansion_policy,
+		warthog::gridmap> dstar(&heuristic, &d_expander, &map);
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::gridmap_expansion_policy> astar(&heuristic, &a_expander);
+
+	uint64_t d_expd = 0, a_expd = 0;
+	double d_time = 0, a_time = 0;
+	uint32_t replans = 0;
+	std::vector<warthog::sn_id_t> path;
+	for(uint32_t i = 0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		warthog::sn_id_t startid = map.to_padded_id(exp->startx(), exp->starty());
+		warthog::sn_id_t goalid = map.to_padded_id(exp->goalx(), exp->goaly());
+		dstar.get_path(startid, goalid, path);
+		if(path.size() < 12) { continue; }
+
+		warthog::label_batch block, unblock;
+		for(uint32_t j = path.size()/3 + 3; j < path.size()/3 + 6; j++)
+		{
+			block.push_back(std::make_pair(path[j], 0));
+			unblock.push_back(std::make_pair(path[j], 1));
+		}
+
+		for(uint32_t step = 0; step < 2; step++)
+		{
+			warthog::sn_id_t agent = path[path.size()/3];
+			dstar.set_labels(step == 0 ? block : unblock);
+			double d_len = dstar.get_path(agent, goalid, path);
+			double a_len = astar.get_length(agent, goalid);
+			if(d_len != a_len)
+			{
+				std::cerr << "replan mismatch! exp " << i << " dstar: " 
+					<< d_len << " astar: " << a_len << std::endl;
+				exit(1);
+			}
+			d_expd += dstar.get_nodes_expanded();
+			a_expd += astar.get_nodes_expanded();
+			d_time += dstar.get_search_time();
+			a_time += astar.get_search_time();
+			replans++;
+			if(path.size() < 3) { break; }
+		}
+		if(path.size() < 3) { dstar.set_labels(unblock); }
+	}
+	std::cerr << replans << " replans. expanded (dstar, astar): " << d_expd
+		<< " " << a_expd << " time (us): " << d_time << " " << a_time << "\n";
+}
+
+// every query in the scenario is solved by one of several interleaved 
+// searches, each advanced by at most 256 expansions at a time. lengths must
+// match those of uninterrupted searches.
+void time_sliced_test(const char* scenfile)
+{
+	const uint32_t num_searches = 16;
+	const uint32_t budget = 256;
+	typedef warthog::flexible_astar<
+		warthog::octile_heuristic,
+		warthog::gridmap_expansion_policy> astar_t;
+
+	warthog::scenario_manager scenmgr;
+	scenmgr.load_scenario(scenfile);
+	warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+
+	warthog::gridmap_expansion_policy ref_expander(&map);
+	astar_t reference(&heuristic, &ref_expander);
+	std::vector<warthog::gridmap_expansion_policy*> expanders;
+	std::vector<astar_t*> searches;
+	std::vector<uint32_t> query(num_searches, 0);
+	for(uint32_t i = 0; i < num_searches; i++)
+	{
+		expanders.push_back(new warthog::gridmap_expansion_policy(&map));
+		searches.push_back(new astar_t(&heuristic, expanders.back()));
+	}
+
+	std::vector<double> step_times, search_times;
+	uint32_t next = 0, running = 0;
+	std::vector<warthog::sn_id_t> path;
+	while(next < scenmgr.num_experiments() || running > 0)
+	{
+		for(uint32_t i = 0; i < num_searches; i++)
+		{
+			astar_t* astar = searches[i];
+			if(astar->get_status() == warthog::SEARCH_RUNNING)
+			{
+				warthog::timer mytimer;
+				mytimer.start();
+				astar->step(budget);
+				mytimer.stop();
+				step_times.push_back(mytimer.elapsed_time_micro());
+				if(astar->get_status() == warthog::SEARCH_RUNNING) { continue; }
+
+				warthog::experiment* exp = scenmgr.get_experiment(query[i]);
+				warthog::sn_id_t startid = 
+					map.to_padded_id(exp->startx(), exp->starty());
+				warthog::sn_id_t goalid = 
+					map.to_padded_id(exp->goalx(), exp->goaly());
+				double len = astar->get_best_path(path);
+				if(astar->get_status() == warthog::SEARCH_NO_PATH) 
+				{ 
+					len = warthog::COST_MAX / (double)warthog::ONE; 
+				}
+				double ref_len = reference.get_length(startid, goalid);
+				search_times.push_back(reference.get_search_time());
+				if(len != ref_len)
+				{
+					std::cerr << "length mismatch! exp " << query[i] 
+						<< " sliced: " << len << " reference: " << ref_len 
+						<< std::endl;
+					exit(1);
+				}
+				astar->end();
+				running--;
+			}
+
+			if(next < scenmgr.num_experiments())
+			{
+				warthog::experiment* exp = scenmgr.get_experiment(next);
+				astar->begin(map.to_padded_id(exp->startx(), exp->starty()),
+						map.to_padded_id(exp->goalx(), exp->goaly()));
+				query[i] = next++;
+				running++;
+			}
+		}
+	}
+	// 99th percentile latencies
+	std::sort(step_times.begin(), step_times.end());
+	std::sort(search_times.begin(), search_times.end());
+	std::cerr << "all lengths match. p99 step: " 
+		<< step_times[step_times.size()*99/100] << "us p99 search: " 
+		<< search_times[search_times.size()*99/100] << "us\n";
+
+	for(uint32_t i = 0; i < num_searches; i++)
+	{
+		delete searches[i];
+		delete expanders[i];
+	}
+}
+
 void flexible_astar_test()
 {
 	bool check_opt = false;
@@ -321,6 +550,8 @@ void blockmap_access_test()
 	std::cout << "/blockmap_access_test..."<<std::endl;
 }
 
+// these tests set f-values directly; full-size search nodes only
+#ifndef WARTHOG_COMPACT_NODES
 void pqueue_insert_test()
 {
 	std::cout << "pqueue_insert_test...\n";
@@ -351,6 +582,93 @@ void pqueue_insert_test()
 	std::cout << "/pqueue_insert_test...\n";
 }
 
+// A*-like workload: push all nodes (random f, g), decrease the key of 
+// every fourth node and then pop everything. returns the time in micros.
+template<class Q>
+double dary_heap_workload(warthog::search_node** nodes, unsigned int num)
+{
+	Q myqueue(1024, true);
+	warthog::timer mytimer;
+	mytimer.start();
+	for(unsigned int i=0; i < num; i++)
+	{
+		myqueue.push(nodes[i]);
+	}
+	for(unsigned int i=0; i < num; i+=4)
+	{
+		nodes[i]->set_f(nodes[i]->get_f() >> 1);
+		myqueue.decrease_key(nodes[i]);
+	}
+
+	warthog::cost_t last = 0;
+	for(unsigned int i=0; i < num; i++)
+	{
+		warthog::search_node* n = myqueue.pop();
+		if(n == 0 || n->get_f() < last)
+		{
+			std::cerr << "err; elements popped out of order\n";
+			exit(1);
+		}
+		last = n->get_f();
+	}
+	assert(myqueue.size() == 0);
+	mytimer.stop();
+	return mytimer.elapsed_time_micro();
+}
+
+void dary_heap_test()
+{
+	std::cout << "dary_heap_test...\n";
+	unsigned int num = 1000000;
+	unsigned int runs = 5;
+	warthog::search_node** nodes = new warthog::search_node*[num];
+	for(unsigned int i=0; i < num; i++)
+	{
+		nodes[i] = new warthog::search_node(i);
+	}
+
+	double time_bheap = 0, time_4heap = 0, time_8heap = 0;
+	for(unsigned int r=0; r < runs; r++)
+	{
+		for(int which = 0; which < 3; which++)
+		{
+			srand(r);
+			for(unsigned int i=0; i < num; i++)
+			{
+				nodes[i]->reset(0);
+				nodes[i]->set_g(rand() % (1 << 20));
+				nodes[i]->set_f(nodes[i]->get_g() + rand() % (1 << 20));
+			}
+			if(which == 0)
+			{
+				time_bheap += dary_heap_workload<warthog::pqueue>(nodes, num);
+			}
+			else if(which == 1)
+			{
+				time_4heap += 
+					dary_heap_workload< warthog::dary_heap<4> >(nodes, num);
+			}
+			else
+			{
+				time_8heap += 
+					dary_heap_workload< warthog::dary_heap<8> >(nodes, num);
+			}
+		}
+	}
+	std::cout << "nodes: "<<num<<" runs: "<<runs<<" (avg micros per run)\n";
+	std::cout << "binary heap: "<< time_bheap / runs << std::endl;
+	std::cout << "4-ary heap: "<< time_4heap / runs << std::endl;
+	std::cout << "8-ary heap: "<< time_8heap / runs << std::endl;
+
+	for(unsigned int i=0; i < num; i++)
+	{
+		delete nodes[i];
+	}
+	delete [] nodes;
+	std::cout << "/dary_heap_test...\n";
+}
+#endif
+
 void gridmap_access_test()
 {
 	std::cout << "gridmap_access_test..."<<std::endl;
@@ -378,3 +696,476 @@ void gridmap_access_test()
 	}
 	std::cout << "gridmap_access_test..."<<std::endl;
 }
+
+// random tiles are blocked and unblocked through a component_index; every
+// so often the index is compared against one built from scratch (the two 
+// must partition the tiles identically)
+void component_index_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	warthog::component_index components(&map);
+	uint32_t width = map.header_width();
+	uint32_t height = map.header_height();
+
+	srand(1);
+	warthog::timer mytimer;
+	double edit_time = 0;
+	uint32_t edits = 0;
+	for(uint32_t round = 0; round < 50; round++)
+	{
+		mytimer.start();
+		for(uint32_t i = 0; i < 1000; i++)
+		{
+			uint32_t id = map.to_padded_id(rand() % width, rand() % height);
+			components.set_label(id, !map.get_label(id));
+		}
+		mytimer.stop();
+		edit_time += mytimer.elapsed_time_micro();
+		edits += 1000;
+
+		warthog::component_index fresh(&map);
+		std::tr1::unordered_map<uint32_t, uint32_t> to_fresh, from_fresh;
+		for(uint32_t id = 0; id < map.height() * map.width(); id++)
+		{
+			uint32_t c1 = components.get_component(id);
+			uint32_t c2 = fresh.get_component(id);
+			if((c1 == warthog::component_index::NONE) != 
+					(c2 == warthog::component_index::NONE) || 
+				(to_fresh.count(c1) && to_fresh[c1] != c2) ||
+				(from_fresh.count(c2) && from_fresh[c2] != c1))
+			{
+				std::cerr << "component mismatch! round " << round << 
+					" tile " << id << std::endl;
+				exit(1);
+			}
+			to_fresh[c1] = c2;
+			from_fresh[c2] = c1;
+		}
+	}
+	std::cerr << "component_index_test: " << edits << " edits; " 
+		<< edit_time / edits << " us per edit" << std::endl;
+}
+
+// paths between random tiles, read from a compressed path database, must 
+// be made of legal moves and be as long as those found by A*
+void cpd_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	warthog::cpd db(&map);
+	warthog::cpd_query query(&db);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+	warthog::gridmap_expansion_policy expander(&map);
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::gridmap_expansion_policy> astar(&heuristic, &expander);
+
+	srand(1);
+	std::vector<warthog::sn_id_t> path;
+	double cpd_time = 0, astar_time = 0;
+	for(uint32_t i = 0; i < 10000; i++)
+	{
+		warthog::sn_id_t startid = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		warthog::sn_id_t goalid = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		if(!map.get_label(startid) || !map.get_label(goalid)) { continue; }
+
+		double len = query.get_path(startid, goalid, path);
+		double ref_len = astar.get_length(startid, goalid);
+		cpd_time += query.get_search_time();
+		astar_time += astar.get_search_time();
+		bool ok = (len == ref_len);
+		for(uint32_t j = 1; ok && j < path.size(); j++)
+		{
+			int32_t dx = (int32_t)(path[j] % map.width()) - 
+				(int32_t)(path[j-1] % map.width());
+			int32_t dy = (int32_t)(path[j] / map.width()) - 
+				(int32_t)(path[j-1] / map.width());
+			ok = abs(dx) <= 1 && abs(dy) <= 1 && map.get_label(path[j]) &&
+				map.get_label(path[j-1] + dx) && 
+				map.get_label(path[j-1] + dy*(int32_t)map.width());
+		}
+		if(!ok)
+		{
+			std::cerr << "cpd mismatch! start " << startid << " goal " 
+				<< goalid << " cpd: " << len << " astar: " << ref_len 
+				<< std::endl;
+			exit(1);
+		}
+	}
+	std::cerr << "cpd_test: " << db.num_runs() << " runs for " 
+		<< db.num_nodes() << " nodes. time (us) cpd: " << cpd_time 
+		<< " astar: " << astar_time << std::endl;
+}
+
+// the landmark heuristic must be admissible (never above the length of 
+// paths found by A*) and consistent (h(n) <= c(n, m) + h(m) for every 
+// neighbour m of n) 
+void landmark_heuristic_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	warthog::landmark_heuristic alt(&map);
+	warthog::octile_heuristic octile(map.width(), map.height());
+	warthog::gridmap_expansion_policy expander(&map);
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::gridmap_expansion_policy> astar(&octile, &expander);
+
+	srand(1);
+	warthog::problem_instance pi;
+	uint64_t alt_total = 0, octile_total = 0;
+	for(uint32_t i = 0; i < 1000; i++)
+	{
+		warthog::sn_id_t id = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		warthog::sn_id_t goalid = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		if(!map.get_label(id) || !map.get_label(goalid)) { continue; }
+
+		warthog::cost_t h = alt.h(id, goalid);
+		double len = astar.get_length(id, goalid);
+		if(len != warthog::COST_MAX / (double)warthog::ONE && 
+				h > len * warthog::ONE + 0.5)
+		{
+			std::cerr << "inadmissible! " << id << " " << goalid << " h: " 
+				<< h << " length: " << len << std::endl;
+			exit(1);
+		}
+		alt_total += h;
+		octile_total += octile.h(id, goalid);
+
+		warthog::search_node n(id);
+		expander.expand(&n, &pi);
+		warthog::search_node* m;
+		warthog::cost_t cost;
+		for(expander.first(m, cost); m != 0; expander.next(m, cost))
+		{
+			if(h > cost + alt.h(m->get_id(), goalid))
+			{
+				std::cerr << "inconsistent! " << id << " " << m->get_id() 
+					<< " " << goalid << std::endl;
+				exit(1);
+			}
+		}
+	}
+	std::cerr << "landmark_heuristic_test: mean h (alt, octile): " 
+		<< alt_total / 1000.0 << " " << octile_total / 1000.0 << std::endl;
+}
+
+// pruning with goal bounding boxes must not change the length of any 
+// path; it should reduce the number of nodes expanded
+void goal_bounding_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	warthog::goal_bounding gb(&map);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+	warthog::gridmap_expansion_policy expander(&map);
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::gridmap_expansion_policy> astar(&heuristic, &expander);
+
+	srand(1);
+	uint64_t expanded = 0, ref_expanded = 0;
+	for(uint32_t i = 0; i < 1000; i++)
+	{
+		warthog::sn_id_t startid = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		warthog::sn_id_t goalid = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		if(!map.get_label(startid) || !map.get_label(goalid)) { continue; }
+
+		expander.set_goal_bounding(0);
+		double ref_len = astar.get_length(startid, goalid);
+		ref_expanded += astar.get_nodes_expanded();
+		expander.set_goal_bounding(&gb);
+		double len = astar.get_length(startid, goalid);
+		expanded += astar.get_nodes_expanded();
+		if(len != ref_len)
+		{
+			std::cerr << "goal bounding mismatch! start " << startid 
+				<< " goal " << goalid << " pruned: " << len 
+				<< " astar: " << ref_len << std::endl;
+			exit(1);
+		}
+	}
+	std::cerr << "goal_bounding_test: nodes expanded (pruned, astar): " 
+		<< expanded << " " << ref_expanded << std::endl;
+}
+
+// the bulk reads of a gridmap must agree with ::get_label, whatever the
+// size of its words
+template<class M>
+void gridmap_word_check(const char* mapfile)
+{
+	M map(mapfile);
+	srand(1);
+	for(uint32_t i = 0; i < 100000; i++)
+	{
+		uint32_t id = map.to_padded_id(
+				rand() % map.header_width(), rand() % map.header_height());
+		uint64_t lower[3], upper[3];
+		map.get_neighbours_64bit(id, lower);
+		map.get_neighbours_upper_64bit(id, upper);
+		for(uint32_t row = 0; row < 3; row++)
+		{
+			uint32_t rowid = id + row*map.width() - map.width();
+			for(uint32_t bit = 0; bit < 64; bit++)
+			{
+				if(((lower[row] >> bit) & 1) != map.get_label(rowid + bit) ||
+					((upper[row] >> bit) & 1) != 
+						map.get_label(rowid + bit - 63))
+				{
+					std::cerr << "gridmap_word_test failed! " << M::WORD_BITS
+						<< " bit words; tile " << id << std::endl;
+					exit(1);
+				}
+			}
+		}
+	}
+	std::cerr << "gridmap_word_test: " << M::WORD_BITS << " bit words; "
+		<< "padded width " << map.width() << "; checksum " 
+		<< map.checksum() << std::endl;
+}
+
+void gridmap_word_test(const char* mapfile)
+{
+	gridmap_word_check<warthog::gridmap8>(mapfile);
+	gridmap_word_check<warthog::gridmap32>(mapfile);
+	gridmap_word_check<warthog::gridmap64>(mapfile);
+}
+
+// every jump scan kernel must stop where a tile-by-tile scan would, from
+// every tile (obstacles included) and in both directions
+void jump_scan_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	const uint64_t* words = map.get_words64();
+	uint32_t w = map.width();
+	const char* names[] = {"scalar", "sse2", "avx2"};
+	for(uint32_t k = 0; k < 3; k++)
+	{
+		const warthog::jump_scan::kernel& kern = 
+			warthog::jump_scan::get_kernel(names[k]);
+		if(strcmp(kern.name_, names[k]))
+		{
+			std::cerr << "jump_scan_test: no " << names[k] << " kernel\n";
+			continue;
+		}
+
+		uint32_t jumps = 0;
+		for(uint32_t y = 0; y < map.header_height(); y++)
+		for(uint32_t x = 0; x < map.header_width(); x++)
+		{
+			uint32_t id = map.to_padded_id(x, y);
+			for(int32_t dir = 1; dir >= -1; dir -= 2)
+			{
+				// reference: one tile at a time
+				uint32_t steps = 0;
+				bool deadend = false;
+				for( ; ; steps++)
+				{
+					uint32_t t = id + dir*(int32_t)steps;
+					if(!map.get_label(t)) { deadend = true; break; }
+					if(steps && ((map.get_label(t-w) && !map.get_label(t-w-dir)) ||
+							(map.get_label(t+w) && !map.get_label(t+w-dir))))
+					{
+						break;
+					}
+				}
+
+				bool kdeadend = !deadend;
+				uint32_t ksteps = dir == 1 ? 
+					kern.east_(words, w, id, kdeadend) :
+					kern.west_(words, w, id, kdeadend);
+				if(ksteps != steps || kdeadend != deadend)
+				{
+					std::cerr << "jump_scan_test failed! kernel " << kern.name_
+						<< " tile ("<<x<<", "<<y<<") dir " << dir << std::endl;
+					exit(1);
+				}
+				jumps++;
+			}
+		}
+		std::cerr << "jump_scan_test: " << kern.name_ << " ok; " 
+			<< jumps << " jumps" << std::endl;
+	}
+}
+
+// diagonal jumps must agree with the original, one step at a time,
+// implementation; from every tile, toward goals on and off the lines
+// which the diagonal jumps scan
+void diagonal_jump_test(const char* mapfile)
+{
+	warthog::gridmap map(mapfile);
+	warthog::online_jump_point_locator jpl(&map);
+	warthog::jps::direction dirs[4] = {warthog::jps::NORTHEAST, 
+		warthog::jps::NORTHWEST, warthog::jps::SOUTHEAST, 
+		warthog::jps::SOUTHWEST};
+	int32_t dx[4] = {1, -1, 1, -1};
+	int32_t dy[4] = {-1, -1, 1, 1};
+
+	srand(1);
+	uint32_t jumps = 0;
+	for(uint32_t y = 0; y < map.header_height(); y++)
+	for(uint32_t x = 0; x < map.header_width(); x++)
+	{
+		uint32_t id = map.to_padded_id(x, y);
+		if(!map.get_label(id)) { continue; }
+		for(uint32_t d = 0; d < 4; d++)
+		{
+			// no goal, a random goal and a goal on a straight line from
+			// some tile of the diagonal
+			int32_t k = rand() % 32;
+			int32_t s = rand() % 64;
+			int32_t gx = x + dx[d]*k + ((rand() & 1) ? dx[d]*s : 0);
+			int32_t gy = y + dy[d]*k + ((rand() & 1) ? 0 : dy[d]*s);
+			uint32_t goals[3] = {warthog::INF, map.to_padded_id(
+					rand() % map.header_width(), rand() % map.header_height()),
+				warthog::INF};
+			if(gx >= 0 && gy >= 0 && gx < (int32_t)map.header_width() && 
+					gy < (int32_t)map.header_height())
+			{
+				goals[2] = map.to_padded_id(gx, gy);
+			}
+
+			for(uint32_t g = 0; g < 3; g++)
+			{
+				uint32_t jp, ref_jp;
+				warthog::cost_t cost, ref_cost;
+				jpl.jump(dirs[d], id, goals[g], jp, cost);
+				jpl.jump_stepwise(dirs[d], id, goals[g], ref_jp, ref_cost);
+				if(jp != ref_jp || cost != ref_cost)
+				{
+					std::cerr << "diagonal_jump_test failed! tile ("<<x<<", "
+						<<y<<") dir " << dirs[d] << " goal " << goals[g] 
+						<< ": " << jp << " " << cost << " vs " << ref_jp 
+						<< " " << ref_cost << std::endl;
+					exit(1);
+				}
+				jumps++;
+			}
+		}
+	}
+	std::cerr << "diagonal_jump_test: " << mapfile << " ok; " 
+		<< jumps << " jumps" << std::endl;
+}
+
+// the rotated map must match a tile-by-tile rotation (as made by the jump
+// point locators before)
+template<class M>
+void rotated_map_compare(M& map, M* rmap, const char* name)
+{
+	for(uint32_t y = 0; y < rmap->height(); y++)
+	for(uint32_t x = 0; x < rmap->width(); x++)
+	{
+		// NB: the padding must be empty too
+		uint32_t rid = y * rmap->width() + x;
+		uint32_t label = 0;
+		uint32_t rx, ry;
+		rmap->to_unpadded_xy(rid, rx, ry);
+		if(rid >= rmap->to_padded_id(0) && 
+				rx < rmap->header_width() && ry < rmap->header_height())
+		{
+			label = map.get_label(
+					map.to_padded_id(ry, map.header_height() - rx - 1));
+		}
+		if(rmap->get_label(rid) != label)
+		{
+			std::cerr << "rotated_map_test failed! " << name 
+				<< " tile (" << x << ", " << y << ")" << std::endl;
+			exit(1);
+		}
+	}
+}
+
+// the rotated map is built once only and follows later changes to the map
+template<class M>
+void rotated_map_check(const char* mapfile, const char* name)
+{
+	M map(mapfile);
+	warthog::timer mytimer;
+	mytimer.start();
+	M* rmap = map.rotated();
+	mytimer.stop();
+	if(map.rotated() != rmap)
+	{
+		std::cerr << "rotated_map_test failed! " << name 
+			<< " rotated twice" << std::endl;
+		exit(1);
+	}
+	rotated_map_compare(map, rmap, name);
+
+	// flip some tiles, including the padding around the map
+	srand(1);
+	for(uint32_t i = 0; i < 1000; i++)
+	{
+		uint32_t id = rand() % (map.width() * map.height());
+		map.set_label(id, map.get_label(id) ? 0 : 1);
+	}
+	rotated_map_compare(map, rmap, name);
+	std::cerr << "rotated_map_test: " << name << " ok; " 
+		<< mytimer.elapsed_time_micro() << "us" << std::endl;
+}
+
+void rotated_map_test(const char* mapfile)
+{
+	rotated_map_check<warthog::gridmap8>(mapfile, "gridmap8");
+	rotated_map_check<warthog::gridmap32>(mapfile, "gridmap32");
+	rotated_map_check<warthog::gridmap64>(mapfile, "gridmap64");
+	rotated_map_check<warthog::weighted_gridmap>(mapfile, "weighted_gridmap");
+}
+
+// a blockmap must read the same tiles as a gridmap, from every tile of
+// the map and for every way of reading them
+void blockmap_test(const char* mapfile)
+{
+	warthog::gridmap gm(mapfile);
+	warthog::blockmap bm(mapfile);
+	int32_t dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+	int32_t dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+	for(uint32_t y = 0; y < gm.header_height(); y++)
+	for(uint32_t x = 0; x < gm.header_width(); x++)
+	{
+		uint32_t gid = gm.to_padded_id(x, y);
+		uint32_t bid = bm.to_padded_id(x, y);
+		uint32_t ux, uy;
+		bm.to_unpadded_xy(bid, ux, uy);
+		bool ok = ux == x && uy == y && bid < bm.padded_mapsize() &&
+			bm.get_label(bid) == gm.get_label(gid);
+
+		// NB: only the three lowest bits of each row are defined
+		uint32_t gtiles = 0, btiles = 0;
+		gm.get_neighbours(gid, (uint8_t*)&gtiles);
+		bm.get_neighbours(bid, (uint8_t*)&btiles);
+		ok = ok && (gtiles & 0x070707) == (btiles & 0x070707);
+
+		// NB: tiles past the end of the row differ (padding)
+		uint32_t g32[3], b32[3];
+		gm.get_neighbours_32bit(gid, g32);
+		bm.get_neighbours_32bit(bid, b32);
+		uint32_t len = std::min<uint32_t>(32, gm.header_width() - x);
+		uint32_t mask = len == 32 ? ~0u : (1u << len) - 1;
+		for(uint32_t i = 0; i < 3; i++)
+		{
+			ok = ok && (g32[i] & mask) == (b32[i] & mask);
+		}
+
+		for(uint32_t d = 0; d < 8; d++)
+		{
+			uint32_t nx, ny;
+			bm.to_unpadded_xy(bm.get_neighbour_id(bid, dx[d], dy[d]), nx, ny);
+			ok = ok && nx == x + dx[d] && ny == y + dy[d] &&
+				bm.get_label(bm.get_neighbour_id(bid, dx[d], dy[d])) ==
+				gm.get_label(gm.get_neighbour_id(gid, dx[d], dy[d]));
+		}
+
+		if(!ok)
+		{
+			std::cerr << "blockmap_test failed! tile (" << x << ", " << y
+				<< ")" << std::endl;
+			exit(1);
+		}
+	}
+	std::cerr << "blockmap_test: " << mapfile << " ok; " 
+		<< bm.get_num_blocks() << " blocks" << std::endl;
+}
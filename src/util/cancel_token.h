@@ -0,0 +1,49 @@
+#ifndef WARTHOG_CANCEL_TOKEN_H
+#define WARTHOG_CANCEL_TOKEN_H
+
+// cancel_token.h
+//
+// A flag used to abort searches from outside. Any thread may call ::cancel
+// at any time; searches which hold the token poll it (a relaxed atomic
+// load) every few expansions and stop with status warthog::SEARCH_ABORTED.
+// A single token can be shared by any number of searches.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include <atomic>
+
+namespace warthog
+{
+
+class cancel_token
+{
+	public:
+		cancel_token() : cancelled_(false) { }
+
+		inline void
+		cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+		// allow the token to be used again
+		inline void
+		reset() { cancelled_.store(false, std::memory_order_relaxed); }
+
+		inline bool
+		is_cancelled()
+		{
+			return cancelled_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<bool> cancelled_;
+
+		// no copy
+		cancel_token(const cancel_token& other) { }
+		cancel_token&
+		operator=(const cancel_token& other) { return *this; }
+};
+
+}
+
+#endif
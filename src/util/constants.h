@@ -15,15 +15,30 @@
 namespace warthog
 {
 	// each node in a weighted grid map uses sizeof(dbword) memory.
-	// in a uniform-cost grid map each dbword is a contiguous set
-	// of nodes s.t. every bit represents a node.
+	// (uniform-cost grid maps store one bit per node, in words of a 
+	// size chosen by the map; see gridmap.h)
 	typedef unsigned char dbword;
+
+	// path costs, in units of warthog::ONE per straight step. 32 bit costs
+	// overflow after roughly 429,000 straight steps (much sooner on 
+	// weighted grids, where step costs are scaled by terrain values). 
+	// compiling with WARTHOG_64BIT_COSTS selects 64 bit costs instead.
+#ifdef WARTHOG_64BIT_COSTS
+	typedef uint64_t cost_t;
+#else
 	typedef uint32_t cost_t;
+#endif
 
-	// gridmap constants
-	static const uint32_t DBWORD_BITS = sizeof(warthog::dbword)*8;
-	static const uint32_t DBWORD_BITS_MASK = (warthog::DBWORD_BITS-1);
-	static const uint32_t LOG2_DBWORD_BITS = ceil(log10(warthog::DBWORD_BITS) / log10(2));
+	// search node identifiers. one bit of each id is reserved (see 
+	// search_node.h) so 32 bit ids address up to 2^31 nodes. compiling 
+	// with WARTHOG_64BIT_IDS selects 64 bit ids instead. NB: this widens
+	// the search code only; grid maps and their expansion policies still
+	// use 32 bit (padded) ids.
+#ifdef WARTHOG_64BIT_IDS
+	typedef uint64_t sn_id_t;
+#else
+	typedef uint32_t sn_id_t;
+#endif
 
 	// search and sort constants
 	static const double DBL_ONE = 1.0f;
@@ -38,7 +53,8 @@ namespace warthog
 	static const warthog::cost_t ONE_OVER_TWO = DBL_ONE_OVER_TWO * ONE;
 	static const warthog::cost_t ONE_OVER_ROOT_TWO = DBL_ONE_OVER_ROOT_TWO * ONE;
 	static const warthog::cost_t ROOT_TWO_OVER_FOUR = DBL_ROOT_TWO * ONE;
-	static const warthog::cost_t INF = 0xffffffff;
+	static const warthog::cost_t INF = 0xffffffff; // also means "no node"
+	static const warthog::cost_t COST_MAX = ~((warthog::cost_t)0);
 
 	// hashing constants
 	static const uint32_t FNV32_offset_basis = 2166136261;
@@ -0,0 +1,305 @@
+#ifndef WARTHOG_DARY_HEAP_H
+#define WARTHOG_DARY_HEAP_H
+
+// dary_heap.h
+//
+// A min priority queue implemented as a d-ary heap (D children per node).
+// Unlike warthog::pqueue, each element of the heap stores a copy of the
+// node's f and g values next to the node pointer. Comparisons during
+// heapify therefore never dereference a search_node; only the position
+// of a moved element is written back to its node (search_node::priority_).
+//
+// A larger arity gives a shallower heap: fewer levels (and cache misses)
+// on the way up, at the cost of more comparisons per level on the way
+// down. The children of an element are stored contiguously; with D = 4
+// and 16 byte elements (on 64 bit platforms) they span at most two 
+// cache lines.
+//
+// The interface mirrors warthog::pqueue so that this class can be used
+// as the open list of warthog::flexible_astar.
+// NB: the cached keys are refreshed by ::push and ::decrease_key. Callers
+// must invoke ::decrease_key after changing the f or g value of a node
+// that is already in the queue (flexible_astar always does).
+//
+// Because keys are stored inline this is also the open list used with 
+// compact search nodes (WARTHOG_COMPACT_NODES), which have no f-value. 
+// In that mode nodes are added with ::push(node, f) and ::decrease_key 
+// shifts the cached f-value by the same amount as the node's g-value.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "search_node.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+namespace warthog
+{
+
+template <uint32_t D>
+class dary_heap
+{
+	public:
+		dary_heap(unsigned int size, bool minqueue)
+			: maxsize_(0), queuesize_(0), elts_(0)
+		{
+			assert(minqueue);
+			resize(size);
+		}
+
+		~dary_heap()
+		{
+			delete [] elts_;
+		}
+
+		// removes all elements from the queue
+		inline void
+		clear()
+		{
+			queuesize_ = 0;
+		}
+
+		// reprioritise the specified element (after its key decreased)
+		inline void
+		decrease_key(warthog::search_node* val)
+		{
+			unsigned int index = val->get_priority();
+			assert(index < queuesize_ && elts_[index].node_ == val);
+#ifdef WARTHOG_COMPACT_NODES
+			elts_[index].f_ = (elts_[index].f_ - elts_[index].g_) + val->get_g();
+#else
+			elts_[index].f_ = val->get_f();
+#endif
+			elts_[index].g_ = val->get_g();
+			heapify_up(index);
+		}
+
+#ifndef WARTHOG_COMPACT_NODES
+		// add a new element to the queue
+		inline void
+		push(warthog::search_node* val)
+		{
+			push(val, val->get_f());
+		}
+#endif
+
+		// add a new element to the queue, with priority @param f
+		inline void
+		push(warthog::search_node* val, warthog::cost_t f)
+		{
+			if(contains(val))
+			{
+				return;
+			}
+
+#ifdef WARTHOG_COMPACT_NODES
+			// positions beyond 24 bits would overwrite pdir (see 
+			// search_node.h)
+			if(queuesize_ == warthog::PRIORITY_MASK)
+			{
+				std::cerr << "err; open list full (max " 
+					<< warthog::PRIORITY_MASK 
+					<< " elements with compact search nodes). aborting\n";
+				exit(1);
+			}
+#endif
+			if(queuesize_+1 > maxsize_)
+			{
+				resize(maxsize_*2);
+			}
+			unsigned int index = queuesize_;
+			elts_[index].f_ = f;
+			elts_[index].g_ = val->get_g();
+			elts_[index].node_ = val;
+			queuesize_++;
+			heapify_up(index);
+		}
+
+		// remove the top element from the queue
+		inline warthog::search_node*
+		pop()
+		{
+			if(queuesize_ == 0)
+			{
+				return 0;
+			}
+
+			warthog::search_node* ans = elts_[0].node_;
+			queuesize_--;
+			if(queuesize_ > 0)
+			{
+				elts_[0] = elts_[queuesize_];
+				heapify_down(0);
+			}
+			return ans;
+		}
+
+		// @return true if the element is in the queue, false otherwise
+		inline bool
+		contains(warthog::search_node* n)
+		{
+			unsigned int priority = n->get_priority();
+			if(priority < queuesize_ && elts_[priority].node_ == n)
+			{
+				return true;
+			}
+			return false;
+		}
+
+		// retrieve the top element without removing it
+		inline warthog::search_node*
+		peek()
+		{
+			if(queuesize_ > 0)
+			{
+				return elts_[0].node_;
+			}
+			return 0;
+		}
+
+		// @return the f-value of the top element (which must exist)
+		inline warthog::cost_t
+		peek_f()
+		{
+			assert(queuesize_ > 0);
+			return elts_[0].f_;
+		}
+
+		inline unsigned int
+		size()
+		{
+			return queuesize_;
+		}
+
+		inline bool
+		is_minqueue()
+		{
+			return true;
+		}
+
+		void
+		print(std::ostream& out)
+		{
+			for(unsigned int i=0; i < queuesize_; i++)
+			{
+				elts_[i].node_->print(out);
+				out << std::endl;
+			}
+		}
+
+		unsigned int
+		mem()
+		{
+			return maxsize_*sizeof(heap_element) + sizeof(*this);
+		}
+
+	private:
+		struct heap_element
+		{
+			warthog::cost_t f_;
+			warthog::cost_t g_;
+			warthog::search_node* node_;
+		};
+
+		unsigned int maxsize_;
+		unsigned int queuesize_;
+		heap_element* elts_;
+
+		// no copy
+		dary_heap(const dary_heap& other) { }
+		dary_heap&
+		operator=(const dary_heap& other) { return *this; }
+
+		// same ordering as search_node::operator<; i.e. lowest f first,
+		// with ties broken in favour of larger g
+		inline bool
+		less(const heap_element& first, const heap_element& second)
+		{
+			if(first.f_ < second.f_) { return true; }
+			if(first.f_ > second.f_) { return false; }
+			return first.g_ > second.g_;
+		}
+
+		// move the element at @param index up (or down) the heap
+		inline void
+		heapify_up(unsigned int index)
+		{
+			assert(index < queuesize_);
+			heap_element elt = elts_[index];
+			while(index > 0)
+			{
+				unsigned int parent = (index-1) / D;
+				if(!less(elt, elts_[parent]))
+				{
+					break;
+				}
+				elts_[index] = elts_[parent];
+				elts_[index].node_->set_priority(index);
+				index = parent;
+			}
+			elts_[index] = elt;
+			elt.node_->set_priority(index);
+		}
+
+		inline void
+		heapify_down(unsigned int index)
+		{
+			heap_element elt = elts_[index];
+			while(true)
+			{
+				unsigned int first_child = index*D + 1;
+				if(first_child >= queuesize_)
+				{
+					break;
+				}
+
+				// find the smallest child
+				unsigned int last_child = first_child + D;
+				if(last_child > queuesize_) { last_child = queuesize_; }
+				unsigned int which = first_child;
+				for(unsigned int c = first_child+1; c < last_child; c++)
+				{
+					if(less(elts_[c], elts_[which])) { which = c; }
+				}
+
+				if(!less(elts_[which], elt))
+				{
+					break;
+				}
+				elts_[index] = elts_[which];
+				elts_[index].node_->set_priority(index);
+				index = which;
+			}
+			elts_[index] = elt;
+			elt.node_->set_priority(index);
+		}
+
+		// allocates more memory so the heap can grow
+		void
+		resize(unsigned int newsize)
+		{
+			if(newsize < queuesize_)
+			{
+				std::cerr << "err; dary_heap::resize newsize < queuesize "
+					<< std::endl;
+				exit(1);
+			}
+
+			heap_element* tmp = new heap_element[newsize];
+			for(unsigned int i=0; i < queuesize_; i++)
+			{
+				tmp[i] = elts_[i];
+			}
+			delete [] elts_;
+			elts_ = tmp;
+			maxsize_ = newsize;
+		}
+};
+
+}
+
+#endif
+
@@ -9,6 +9,11 @@
 // @created: 21/08/2012
 //
 
+#include "stdint.h"
+
+#include <utility>
+#include <vector>
+
 namespace warthog
 {
 namespace helpers
@@ -29,6 +34,26 @@ index_to_xy(unsigned int id, unsigned int mapwidth,
 //	}
 }
 
+// convert a path of padded ids (e.g. one computed by flexible_astar) into a
+// sequence of (x, y) coordinates on the original, unpadded, map. 
+// MAP is any map type that provides ::to_unpadded_xy, such as 
+// warthog::gridmap or warthog::weighted_gridmap. 
+// @param xy is cleared first; no memory is allocated once it has 
+// sufficient capacity.
+template<class MAP>
+inline void
+to_unpadded_xy_path(MAP* map, std::vector<uint32_t>& path, 
+		std::vector< std::pair<uint32_t, uint32_t> >& xy)
+{
+	xy.clear();
+	for(uint32_t i = 0; i < path.size(); i++)
+	{
+		uint32_t x, y;
+		map->to_unpadded_xy(path[i], x, y);
+		xy.push_back(std::pair<uint32_t, uint32_t>(x, y));
+	}
+}
+
 }
 }
 
@@ -1,5 +1,7 @@
 #include "pqueue.h"
 
+#ifndef WARTHOG_COMPACT_NODES
+
 warthog::pqueue::pqueue(unsigned int s, bool minqueue) 
 	: maxsize_(s), minqueue_(minqueue), queuesize_(0), elts_(0)
 {
@@ -170,3 +172,4 @@ warthog::pqueue::print(std::ostream& out)
 	}
 }
 
+#endif // WARTHOG_COMPACT_NODES
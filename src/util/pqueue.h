@@ -15,6 +15,10 @@
 #include <cassert>
 #include <iostream>
 
+// NB: requires f-values stored in search nodes; not available when 
+// compiling with WARTHOG_COMPACT_NODES (use warthog::dary_heap instead).
+#ifndef WARTHOG_COMPACT_NODES
+
 namespace warthog
 {
 
@@ -147,5 +151,7 @@ class pqueue
 
 }
 
+#endif // WARTHOG_COMPACT_NODES
+
 #endif
 
@@ -0,0 +1,206 @@
+#include "radix_heap.h"
+
+#ifndef WARTHOG_COMPACT_NODES
+
+warthog::radix_heap::radix_heap(unsigned int size, bool minqueue)
+	: last_(0), queuesize_(0)
+{
+	assert(minqueue);
+	buckets_[0].reserve(size);
+}
+
+warthog::radix_heap::~radix_heap()
+{
+}
+
+void
+warthog::radix_heap::push(warthog::search_node* val)
+{
+	if(contains(val))
+	{
+		return;
+	}
+	insert(val);
+	queuesize_++;
+}
+
+warthog::search_node*
+warthog::radix_heap::pop()
+{
+	if(peek() == 0)
+	{
+		return 0;
+	}
+
+	std::vector<warthog::search_node*>& heap = buckets_[0];
+	warthog::search_node* ans = heap[0];
+	ans->set_priority(warthog::INF);
+	heap[0] = heap.back();
+	heap.pop_back();
+	queuesize_--;
+
+	if(heap.size() > 0)
+	{
+		set_location(heap[0], 0, 0);
+		heapify_down(0);
+	}
+	return ans;
+}
+
+void
+warthog::radix_heap::decrease_key(warthog::search_node* val)
+{
+	assert(contains(val));
+	uint32_t bucket = val->get_priority() >>
+		warthog::radix_heap_ns::BUCKET_SHIFT;
+	if(bucket == 0)
+	{
+		heapify_up(val->get_priority() & warthog::radix_heap_ns::INDEX_MASK);
+		return;
+	}
+
+	// the new key may belong to a lower bucket
+	uint32_t new_bucket = bucket_of(val->get_f());
+	if(new_bucket != bucket)
+	{
+		remove(val);
+		insert(val);
+	}
+}
+
+void
+warthog::radix_heap::insert(warthog::search_node* n)
+{
+	uint32_t bucket = bucket_of(n->get_f());
+	std::vector<warthog::search_node*>& elts = buckets_[bucket];
+	set_location(n, bucket, elts.size());
+	elts.push_back(n);
+	if(bucket == 0)
+	{
+		heapify_up(elts.size()-1);
+	}
+}
+
+void
+warthog::radix_heap::remove(warthog::search_node* n)
+{
+	uint32_t bucket = n->get_priority() >>
+		warthog::radix_heap_ns::BUCKET_SHIFT;
+	uint32_t index = n->get_priority() & warthog::radix_heap_ns::INDEX_MASK;
+	assert(bucket > 0);
+
+	std::vector<warthog::search_node*>& elts = buckets_[bucket];
+	elts[index] = elts.back();
+	set_location(elts[index], bucket, index);
+	elts.pop_back();
+	n->set_priority(warthog::INF);
+}
+
+void
+warthog::radix_heap::redistribute()
+{
+	assert(buckets_[0].size() == 0 && queuesize_ > 0);
+
+	uint32_t bucket = 1;
+	while(buckets_[bucket].size() == 0) { bucket++; }
+	assert(bucket < warthog::radix_heap_ns::NUM_BUCKETS);
+
+	std::vector<warthog::search_node*>& elts = buckets_[bucket];
+	warthog::cost_t min = elts[0]->get_f();
+	for(uint32_t i = 1; i < elts.size(); i++)
+	{
+		if(elts[i]->get_f() < min) { min = elts[i]->get_f(); }
+	}
+
+	// every element moves to a strictly lower bucket
+	last_ = min;
+	for(uint32_t i = 0; i < elts.size(); i++)
+	{
+		insert(elts[i]);
+	}
+	elts.clear();
+}
+
+void
+warthog::radix_heap::heapify_up(unsigned int index)
+{
+	std::vector<warthog::search_node*>& heap = buckets_[0];
+	while(index > 0)
+	{
+		unsigned int parent = (index-1) >> 1;
+		if(*heap[index] < *heap[parent])
+		{
+			swap(parent, index);
+			index = parent;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void
+warthog::radix_heap::heapify_down(unsigned int index)
+{
+	std::vector<warthog::search_node*>& heap = buckets_[0];
+	unsigned int first_leaf_index = heap.size() >> 1;
+	while(index < first_leaf_index)
+	{
+		unsigned int child1 = (index<<1)+1;
+		unsigned int child2 = (index<<1)+2;
+		unsigned int which = child1;
+		if((child2 < heap.size()) && *heap[child2] < *heap[child1])
+		{
+			which = child2;
+		}
+
+		if(*heap[which] < *heap[index])
+		{
+			swap(index, which);
+			index = which;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void
+warthog::radix_heap::clear()
+{
+	for(uint32_t i = 0; i < warthog::radix_heap_ns::NUM_BUCKETS; i++)
+	{
+		buckets_[i].clear();
+	}
+	queuesize_ = 0;
+	last_ = 0;
+}
+
+unsigned int
+warthog::radix_heap::mem()
+{
+	unsigned int bytes = sizeof(*this);
+	for(uint32_t i = 0; i < warthog::radix_heap_ns::NUM_BUCKETS; i++)
+	{
+		bytes += buckets_[i].capacity() * sizeof(warthog::search_node*);
+	}
+	return bytes;
+}
+
+void
+warthog::radix_heap::print(std::ostream& out)
+{
+	for(uint32_t i = 0; i < warthog::radix_heap_ns::NUM_BUCKETS; i++)
+	{
+		for(uint32_t j = 0; j < buckets_[i].size(); j++)
+		{
+			out << "bucket " << i << " ";
+			buckets_[i][j]->print(out);
+			out << std::endl;
+		}
+	}
+}
+
+#endif // WARTHOG_COMPACT_NODES
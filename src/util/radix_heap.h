@@ -0,0 +1,193 @@
+#ifndef WARTHOG_RADIX_HEAP_H
+#define WARTHOG_RADIX_HEAP_H
+
+// radix_heap.h
+//
+// A monotone min priority queue for integer keys (f-values of type
+// warthog::cost_t). Elements are kept in 33 (65 with 64 bit costs) 
+// unordered buckets; an element with key k is stored in bucket 0 if k is 
+// equal to the last minimum key (last_) and otherwise in bucket b where 
+// 2^(b-1) is the most significant bit in which k and last_ differ. When 
+// bucket 0 empties, the first non-empty bucket is scanned for its minimum
+// key, which becomes last_, and its elements are redistributed into lower
+// buckets. Each element moves at most once for every bit of the key during
+// its lifetime in the queue, no matter how wide the range of f-values.
+//
+// Bucket 0 is itself a small binary heap, ordered by search_node::operator<.
+// Nodes with equal f are therefore popped in favour of larger g, just
+// like warthog::pqueue.
+//
+// The interface mirrors warthog::pqueue so that this class can be used
+// as the open list of warthog::flexible_astar.
+//
+// NB: keys must be monotone; i.e. a pushed (or decreased) key should not
+// be smaller than the key of the last element popped. This holds for A*
+// with a consistent heuristic (e.g. octile, unit weight). Smaller keys are
+// tolerated but treated as if equal to last_; they are popped next, but
+// not necessarily in order.
+//
+// Each node stores its location in the queue using search_node::priority_:
+// the top 6 bits hold the bucket and the low 26 bits its index therein
+// (7 and 25 bits with 64 bit costs).
+//
+// Theoretical details:
+// [Ahuja R. K., Mehlhorn K., Orlin J. and Tarjan R. E., 1990,
+// Faster Algorithms for the Shortest Path Problem, JACM]
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include "search_node.h"
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// NB: requires f-values stored in search nodes; not available when 
+// compiling with WARTHOG_COMPACT_NODES (use warthog::dary_heap instead).
+#ifndef WARTHOG_COMPACT_NODES
+
+namespace warthog
+{
+
+namespace radix_heap_ns
+{
+	const uint32_t NUM_BUCKETS = sizeof(warthog::cost_t)*8 + 1;
+	const uint32_t BUCKET_SHIFT = (NUM_BUCKETS > 64) ? 25 : 26;
+	const uint32_t INDEX_MASK = (1 << BUCKET_SHIFT) - 1;
+}
+
+class radix_heap
+{
+	public:
+		// @param size: initial capacity of the bucket that holds the
+		// minimum elements. @param minqueue must be true.
+		radix_heap(unsigned int size, bool minqueue);
+		~radix_heap();
+
+		// removes all elements from the queue
+		void
+		clear();
+
+		// reprioritise the specified element
+		void
+		decrease_key(warthog::search_node* val);
+
+		// add a new element to the queue
+		void
+		push(warthog::search_node* val);
+
+		// remove the top element from the queue
+		warthog::search_node*
+		pop();
+
+		// @return true if the element is in the queue, false otherwise
+		inline bool
+		contains(warthog::search_node* n)
+		{
+			uint32_t bucket = n->get_priority() >>
+				warthog::radix_heap_ns::BUCKET_SHIFT;
+			uint32_t index = n->get_priority() &
+				warthog::radix_heap_ns::INDEX_MASK;
+			if(bucket < warthog::radix_heap_ns::NUM_BUCKETS &&
+				index < buckets_[bucket].size() &&
+				buckets_[bucket][index] == n)
+			{
+				return true;
+			}
+			return false;
+		}
+
+		// retrieve the top element without removing it
+		inline warthog::search_node*
+		peek()
+		{
+			if(buckets_[0].size() == 0)
+			{
+				if(queuesize_ == 0) { return 0; }
+				redistribute();
+			}
+			return buckets_[0][0];
+		}
+
+		inline unsigned int
+		size()
+		{
+			return queuesize_;
+		}
+
+		inline bool
+		is_minqueue()
+		{
+			return true;
+		}
+
+		void
+		print(std::ostream& out);
+
+		unsigned int
+		mem();
+
+	private:
+		std::vector<warthog::search_node*>
+			buckets_[warthog::radix_heap_ns::NUM_BUCKETS];
+		warthog::cost_t last_;
+		unsigned int queuesize_;
+
+		inline uint32_t
+		bucket_of(warthog::cost_t key)
+		{
+			if(key <= last_) { return 0; }
+#ifdef WARTHOG_64BIT_COSTS
+			return 64 - __builtin_clzll(key ^ last_);
+#else
+			return 32 - __builtin_clz(key ^ last_);
+#endif
+		}
+
+		inline void
+		set_location(warthog::search_node* n, uint32_t bucket, uint32_t index)
+		{
+			assert(index <= warthog::radix_heap_ns::INDEX_MASK);
+			n->set_priority((bucket << warthog::radix_heap_ns::BUCKET_SHIFT)
+				   	| index);
+		}
+
+		// append @param n to the appropriate bucket
+		void
+		insert(warthog::search_node* n);
+
+		// remove @param n from a (unordered) bucket other than bucket 0
+		void
+		remove(warthog::search_node* n);
+
+		// empty the first non-empty bucket into lower buckets
+		void
+		redistribute();
+
+		// bucket 0 heap operations
+		void
+		heapify_up(unsigned int index);
+
+		void
+		heapify_down(unsigned int index);
+
+		inline void
+		swap(unsigned int index1, unsigned int index2)
+		{
+			std::vector<warthog::search_node*>& heap = buckets_[0];
+			warthog::search_node* tmp = heap[index1];
+			heap[index1] = heap[index2];
+			set_location(heap[index1], 0, index1);
+			heap[index2] = tmp;
+			set_location(tmp, 0, index2);
+		}
+};
+
+}
+
+#endif // WARTHOG_COMPACT_NODES
+
+#endif
+
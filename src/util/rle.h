@@ -0,0 +1,98 @@
+#ifndef WARTHOG_RLE_H
+#define WARTHOG_RLE_H
+
+// rle.h
+//
+// Run-length encoding for sequences of small symbols (at most 16 distinct
+// values), such as the first-move tables of warthog::cpd.
+//
+// A run is a single 32 bit word: the index of its first element (high 28
+// bits) and its symbol (low 4 bits). An encoded sequence is an array of
+// runs sorted by index, so the runs compare in the same order as the
+// indexes they start at and the symbol at any index can be found with a
+// binary search.
+//
+// The input to ::encode is not a sequence of symbols but, for each
+// element, a bitmask of acceptable symbols (bit i set = symbol i will do);
+// an empty mask means that any symbol will do. The encoder greedily
+// extends the current run for as long as some symbol is acceptable to
+// every element in it. For first-move tables, where an element often has
+// several optimal moves (or none at all, if it is unreachable) this
+// freedom produces far fewer runs than a fixed choice of symbol.
+//
+// @author: agent
+// @created: 18/10/2026
+//
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+namespace warthog
+{
+
+namespace rle
+{
+
+typedef uint32_t run;
+
+static const uint32_t SYMBOL_BITS = 4;
+static const uint32_t SYMBOL_MASK = (1 << SYMBOL_BITS) - 1;
+static const uint32_t MAX_INDEX = (1u << (32 - SYMBOL_BITS)) - 1;
+
+inline warthog::rle::run
+make_run(uint32_t index, uint32_t symbol)
+{
+	return (index << SYMBOL_BITS) | symbol;
+}
+
+inline uint32_t
+get_index(warthog::rle::run r) { return r >> SYMBOL_BITS; }
+
+inline uint32_t
+get_symbol(warthog::rle::run r) { return r & SYMBOL_MASK; }
+
+// compress the @param n elements of @param masks (see above) and append
+// the runs to @param out.
+// @return the number of runs appended (at least one)
+template<class T>
+uint32_t
+encode(const T* masks, uint32_t n, std::vector<warthog::rle::run>& out)
+{
+	uint32_t begin = out.size();
+	uint32_t start = 0;
+	uint32_t candidates = (1 << (SYMBOL_MASK + 1)) - 1; // any symbol
+	for(uint32_t i = 0; i < n; i++)
+	{
+		uint32_t m = masks[i];
+		if(m == 0) { continue; }
+		if(candidates & m)
+		{
+			candidates &= m;
+			continue;
+		}
+		out.push_back(make_run(start, __builtin_ctz(candidates)));
+		start = i;
+		candidates = m;
+	}
+	out.push_back(make_run(start, __builtin_ctz(candidates)));
+	return out.size() - begin;
+}
+
+// @return the symbol at position @param index of the sequence encoded by
+// the runs [@param begin, @param end)
+inline uint32_t
+decode(const warthog::rle::run* begin, const warthog::rle::run* end,
+		uint32_t index)
+{
+	// the last run that starts at or before index
+	const warthog::rle::run* r =
+		std::upper_bound(begin, end, make_run(index, SYMBOL_MASK));
+	return get_symbol(*(r - 1));
+}
+
+}
+
+}
+
+#endif
@@ -4,16 +4,27 @@
 // @created: August 2012
 //
 
+#include "batch_astar.h"
+#include "bidirectional_astar.h"
 #include "cfg.h"
+#include "component_index.h"
+#include "cpd.h"
+#include "dary_heap.h"
 #include "flexible_astar.h"
+#include "goal_bounding.h"
+#include "blockmap.h"
 #include "gridmap.h"
 #include "gridmap_expansion_policy.h"
+#include "landmark_heuristic.h"
 #include "jps_expansion_policy.h"
 #include "jps_expansion_policy_wgm.h"
 #include "jps2_expansion_policy.h"
 #include "jpsplus_expansion_policy.h"
 #include "jps2plus_expansion_policy.h"
+#include "offline_jump_point_locator.h"
+#include "online_jump_point_locator.h"
 #include "octile_heuristic.h"
+#include "radix_heap.h"
 #include "scenario_manager.h"
 #include "weighted_gridmap.h"
 #include "wgridmap_expansion_policy.h"
@@ -21,6 +32,7 @@
 
 #include "getopt.h"
 
+#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 #include <tr1/unordered_map>
@@ -34,19 +46,101 @@ int verbose = 0;
 int print_help = 0;
 // treat the map as a weighted-cost grid
 int wgm = 0;
+// store the map in blocks of tiles (see blockmap.h)
+int tiled = 0;
+// per-query search limits (0 = no limit)
+uint32_t node_budget = 0;
+double time_limit = 0;
+// reject queries between disconnected tiles (see component_index.h)
+int components = 0;
+// prune successors with goal bounding boxes (see goal_bounding.h)
+int goalbounding = 0;
+// landmark heuristic for astar (0 = octile heuristic)
+uint32_t landmarks = 0;
+uint32_t selection = warthog::landmark_ns::AVOID;
 
 void
 help()
 {
 	std::cerr << "valid parameters:\n"
-	<< "--alg [astar | jps | jps2 | jps+ | jps2+ | astar | jps | sssp ]\n"
+	<< "--alg [astar | bi-astar | cpd | jps | jps2 | jps+ | jps2+ | sssp ]\n"
 	<< "--scen [scenario filename]\n"
 	<< "--gen [map filename]\n"
 	<< "--wgm (optional)\n"
+	<< "--threads [number of worker threads] (optional)\n"
+	<< "--queue [bheap | 4heap | radix] (optional)\n"
+	<< "--pool [blocklist | flat] (optional)\n"
+	<< "--tiled (optional)\n"
+	<< "--budget [max expansions per query] (optional)\n"
+	<< "--deadline [max microseconds per query] (optional)\n"
+	<< "--components (optional)\n"
+	<< "--goalbounding (optional)\n"
+	<< "--landmarks [number of landmarks] (optional)\n"
+	<< "--selection [avoid | farthest] (optional)\n"
 	<< "--checkopt (optional)\n"
 	<< "--verbose (optional)\n";
 }
 
+// apply the per-query search limits to @param astar
+template<class A>
+void
+set_limits(A& astar)
+{
+	astar.set_node_budget(node_budget);
+	astar.set_time_limit(time_limit);
+}
+
+// the heuristic used by run_astar: octile distance or, with --landmarks, 
+// differential bounds (see landmark_heuristic.h)
+void
+new_heuristic(warthog::gridmap& map, warthog::octile_heuristic*& heuristic)
+{
+	heuristic = new warthog::octile_heuristic(map.width(), map.height());
+}
+
+void
+new_heuristic(warthog::gridmap& map, warthog::landmark_heuristic*& heuristic)
+{
+	heuristic = new warthog::landmark_heuristic(&map, landmarks, selection);
+}
+
+void
+new_heuristic(warthog::blockmap& map, 
+		warthog::map_octile_heuristic<warthog::blockmap>*& heuristic)
+{
+	heuristic = new warthog::map_octile_heuristic<warthog::blockmap>(&map);
+}
+
+// @return goal bounding boxes for @param map, already given to 
+// @param expander, if --goalbounding is set, or else null
+template<class E>
+warthog::goal_bounding*
+new_goal_bounding(warthog::gridmap& map, E& expander)
+{
+	if(!goalbounding) { return 0; }
+	warthog::goal_bounding* gb = new warthog::goal_bounding(&map);
+	expander.set_goal_bounding(gb);
+	return gb;
+}
+
+// NB: goal bounding and component indexes need a row-major map
+template<class E>
+warthog::goal_bounding*
+new_goal_bounding(warthog::blockmap& map, E& expander) { return 0; }
+
+warthog::component_index*
+new_component_index(warthog::blockmap& map) { return 0; }
+
+// @return a connected-component index for @param map if --components 
+// is set, or else null
+template<class M>
+warthog::component_index*
+new_component_index(M& map)
+{
+	if(!components) { return 0; }
+	return new warthog::component_index(&map);
+}
+
 void
 check_optimality(double len, warthog::experiment* exp)
 {
@@ -70,7 +164,7 @@ check_optimality(double len, warthog::experiment* exp)
 		}
 	}
 
-	int delta = abs(int_len - int_opt);
+	int delta = abs((int)(int_len - int_opt));
 	if( abs(delta - epsilon) > epsilon)
 	{
 		std::stringstream strpathlen;
@@ -99,19 +193,22 @@ run_jpsplus(warthog::scenario_manager& scenmgr)
     warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
 	warthog::jpsplus_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
+	warthog::goal_bounding* gb = new_goal_bounding(map, expander);
 
 	warthog::flexible_astar<
 		warthog::octile_heuristic,
 	   	warthog::jpsplus_expansion_policy> astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
 
 	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
 	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid),
 			   	map.to_padded_id(goalid));
@@ -130,7 +227,10 @@ run_jpsplus(warthog::scenario_manager& scenmgr)
 
 		check_optimality(len, exp);
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) + (gb ? gb->mem() : 0) << "\n";
+	delete ci;
+	delete gb;
 }
 
 void
@@ -144,14 +244,16 @@ run_jps2plus(warthog::scenario_manager& scenmgr)
 		warthog::octile_heuristic,
 	   	warthog::jps2plus_expansion_policy> astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
 
 	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
 	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid),
 			   	map.to_padded_id(goalid));
@@ -170,7 +272,9 @@ run_jps2plus(warthog::scenario_manager& scenmgr)
 
 		check_optimality(len, exp);
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
 }
 
 void
@@ -184,14 +288,16 @@ run_jps2(warthog::scenario_manager& scenmgr)
 		warthog::octile_heuristic,
 	   	warthog::jps2_expansion_policy> astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
 
 	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
 	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid),
 			   	map.to_padded_id(goalid));
@@ -210,28 +316,73 @@ run_jps2(warthog::scenario_manager& scenmgr)
 
 		check_optimality(len, exp);
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
 }
 
+// every path is read from a compressed path database (built with 
+// @param nthreads threads, if need be)
+void
+run_cpd(warthog::scenario_manager& scenmgr, uint32_t nthreads)
+{
+    warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	warthog::cpd db(&map, nthreads);
+	warthog::cpd_query query(&db);
+
+	// NB: cpd reports the number of moves looked up as nodes touched
+	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
+	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		double len = query.get_length(
+				map.to_padded_id(startid),
+			   	map.to_padded_id(goalid));
+		if(len == warthog::COST_MAX / (double)warthog::ONE)
+		{
+			len = 0;
+		}
+
+		std::cout << i<<"\t" << "cpd" << "\t" 
+		<< 0 << "\t" 
+		<< 0 << "\t"
+		<< query.get_moves() << "\t"
+		<< query.get_search_time()  << "\t"
+		<< len << "\t" 
+		<< scenmgr.last_file_loaded() << std::endl;
+
+		check_optimality(len, exp);
+	}
+	std::cerr << "done. preprocessing time: " << db.get_preproc_time() / 1e6
+		<< "s total memory: "<< db.mem() + query.mem() + scenmgr.mem() << "\n";
+}
+
+template<class E, class Q>
 void
 run_jps(warthog::scenario_manager& scenmgr)
 {
     warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
-	warthog::jps_expansion_policy expander(&map);
+	E expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::jps_expansion_policy> astar(&heuristic, &expander);
+	warthog::flexible_astar<warthog::octile_heuristic, E, Q> 
+		astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
+	set_limits(astar);
+	uint32_t aborted = 0;
 
 	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
 	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid),
 			   	map.to_padded_id(goalid));
@@ -248,22 +399,31 @@ run_jps(warthog::scenario_manager& scenmgr)
 		<< len << "\t" 
 		<< scenmgr.last_file_loaded() << std::endl;
 
-		check_optimality(len, exp);
+		if(astar.get_status() == warthog::SEARCH_ABORTED) { aborted++; }
+		else { check_optimality(len, exp); }
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	if(aborted) { std::cerr << "aborted queries: " << aborted << "\n"; }
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
 }
 
+template<class M, class E, class Q, class H>
 void
 run_astar(warthog::scenario_manager& scenmgr)
 {
-    warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
-	warthog::gridmap_expansion_policy expander(&map);
-	warthog::octile_heuristic heuristic(map.width(), map.height());
+    M map(scenmgr.get_experiment(0)->map().c_str());
+	E expander(&map);
+	H* heuristic;
+	new_heuristic(map, heuristic);
+	warthog::goal_bounding* gb = new_goal_bounding(map, expander);
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::gridmap_expansion_policy> astar(&heuristic, &expander);
+	warthog::flexible_astar<H, E, Q> astar(heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
+	set_limits(astar);
+	uint32_t aborted = 0;
 
 
 	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
@@ -271,8 +431,8 @@ run_astar(warthog::scenario_manager& scenmgr)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid), 
 				map.to_padded_id(goalid));
@@ -289,11 +449,18 @@ run_astar(warthog::scenario_manager& scenmgr)
 		<< len << "\t" 
 		<< scenmgr.last_file_loaded() << std::endl;
 
-		check_optimality(len, exp);
+		if(astar.get_status() == warthog::SEARCH_ABORTED) { aborted++; }
+		else { check_optimality(len, exp); }
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	if(aborted) { std::cerr << "aborted queries: " << aborted << "\n"; }
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) + (gb ? gb->mem() : 0) << "\n";
+	delete heuristic;
+	delete ci;
+	delete gb;
 }
 
+template<class Q>
 void
 run_wgm_astar(warthog::scenario_manager& scenmgr)
 {
@@ -303,8 +470,10 @@ run_wgm_astar(warthog::scenario_manager& scenmgr)
 
 	warthog::flexible_astar<
 		warthog::octile_heuristic,
-	   	warthog::wgridmap_expansion_policy> astar(&heuristic, &expander);
+	   	warthog::wgridmap_expansion_policy, Q> astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
     // cheapest terrain (movingai benchmarks) has ascii value '.'; we scale
     // all heuristic values accordingly (otherwise the heuristic doesn't 
     // impact f-values much and search starts to behave like dijkstra)
@@ -315,8 +484,8 @@ run_wgm_astar(warthog::scenario_manager& scenmgr)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid), 
 				map.to_padded_id(goalid));
@@ -335,7 +504,9 @@ run_wgm_astar(warthog::scenario_manager& scenmgr)
 
 		check_optimality(len, exp);
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
 }
 
 void
@@ -355,7 +526,7 @@ run_wgm_sssp(warthog::scenario_manager& scenmgr)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
 		astar.get_length(map.to_padded_id(startid), warthog::INF);
 
 		std::cout << i<<"\t" << "sssp_wgm" << "\t" 
@@ -379,6 +550,8 @@ run_jps_wgm(warthog::scenario_manager& scenmgr)
 		warthog::octile_heuristic,
 	   	warthog::jps_expansion_policy_wgm> astar(&heuristic, &expander);
 	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
     // cheapest terrain (movingai benchmarks) has ascii value '.'; we scale
     // all heuristic values accordingly (otherwise the heuristic doesn't 
     // impact f-values much and search starts to behave like dijkstra)
@@ -389,8 +562,8 @@ run_jps_wgm(warthog::scenario_manager& scenmgr)
 	{
 		warthog::experiment* exp = scenmgr.get_experiment(i);
 
-		int startid = exp->starty() * exp->mapwidth() + exp->startx();
-		int goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
 		double len = astar.get_length(
 				map.to_padded_id(startid),
 			   	map.to_padded_id(goalid));
@@ -409,7 +582,225 @@ run_jps_wgm(warthog::scenario_manager& scenmgr)
 
 		check_optimality(len, exp);
 	}
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
+}
+
+// bidirectional A* on a map of type M (with an expansion policy of type E
+// for each direction); @param hscale as per flexible_astar::set_hscale
+template<class M, class E, class Q>
+void
+run_bi_astar(warthog::scenario_manager& scenmgr, const char* name, 
+		double hscale)
+{
+    M map(scenmgr.get_experiment(0)->map().c_str());
+	E fexpander(&map);
+	E bexpander(&map);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+
+	warthog::bidirectional_astar<warthog::octile_heuristic, E, Q> 
+		astar(&heuristic, &fexpander, &bexpander);
+	astar.set_verbose(verbose);
+	warthog::component_index* ci = new_component_index(map);
+	astar.set_component_index(ci);
+	astar.set_hscale(hscale);
+
+	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
+	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		double len = astar.get_length(
+				map.to_padded_id(startid), 
+				map.to_padded_id(goalid));
+		if(len == warthog::INF)
+		{
+			len = 0;
+		}
+
+		std::cout << i<<"\t" << name << "\t" 
+		<< astar.get_nodes_expanded() << "\t" 
+		<< astar.get_nodes_generated() << "\t"
+		<< astar.get_nodes_touched() << "\t"
+		<< astar.get_search_time()  << "\t"
+		<< len << "\t" 
+		<< scenmgr.last_file_loaded() << std::endl;
+
+		check_optimality(len, exp);
+	}
+	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
+}
+
+template<class M, class E>
+void
+run_bi_astar_with(warthog::scenario_manager& scenmgr, std::string& queue,
+		const char* name, double hscale)
+{
+	if(queue == "4heap") 
+	{ 
+		run_bi_astar<M, E, warthog::dary_heap<4> >(scenmgr, name, hscale); 
+	}
+#ifndef WARTHOG_COMPACT_NODES
+	else if(queue == "radix") 
+	{ 
+		run_bi_astar<M, E, warthog::radix_heap>(scenmgr, name, hscale); 
+	}
+#endif
+	else 
+	{ 
+		run_bi_astar<M, E, warthog::default_open_list>(scenmgr, name, hscale);
+	}
+}
+
+// run the search with the open list specified by @param queue
+template<class M, class E, class H>
+void
+run_astar_with(warthog::scenario_manager& scenmgr, std::string& queue)
+{
+	if(queue == "4heap") 
+	{ 
+		run_astar<M, E, warthog::dary_heap<4>, H>(scenmgr); 
+	}
+#ifndef WARTHOG_COMPACT_NODES
+	else if(queue == "radix") 
+	{ 
+		run_astar<M, E, warthog::radix_heap, H>(scenmgr); 
+	}
+#endif
+	else { run_astar<M, E, warthog::default_open_list, H>(scenmgr); }
+}
+
+template<class E>
+void
+run_astar_with(warthog::scenario_manager& scenmgr, std::string& queue)
+{
+	if(landmarks)
+	{
+		run_astar_with<warthog::gridmap, E, warthog::landmark_heuristic>(
+				scenmgr, queue);
+	}
+	else 
+	{ 
+		run_astar_with<warthog::gridmap, E, warthog::octile_heuristic>(
+				scenmgr, queue); 
+	}
+}
+
+// as above, on a warthog::blockmap
+template<class E>
+void
+run_tiled_astar_with(warthog::scenario_manager& scenmgr, std::string& queue)
+{
+	run_astar_with<warthog::blockmap, E, 
+		warthog::map_octile_heuristic<warthog::blockmap> >(scenmgr, queue);
+}
+
+template<class E>
+void
+run_jps_with(warthog::scenario_manager& scenmgr, std::string& queue)
+{
+	if(queue == "4heap") { run_jps<E, warthog::dary_heap<4> >(scenmgr); }
+#ifndef WARTHOG_COMPACT_NODES
+	else if(queue == "radix") { run_jps<E, warthog::radix_heap>(scenmgr); }
+#endif
+	else { run_jps<E, warthog::default_open_list>(scenmgr); }
+}
+
+// solve all instances in the scenario as a single batch, using one 
+// worker thread for each expansion policy in @param expanders
+template<class E>
+void
+run_batch(warthog::scenario_manager& scenmgr, warthog::gridmap& map,
+		std::vector<E*>& expanders, std::string alg_name)
+{
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+	warthog::batch_astar<warthog::octile_heuristic, E> 
+		batch(&heuristic, expanders);
+	set_limits(batch);
+	warthog::component_index* ci = new_component_index(map);
+	batch.set_component_index(ci);
+
+	std::vector< std::pair<warthog::sn_id_t, warthog::sn_id_t> > queries;
+	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+		queries.push_back(std::pair<warthog::sn_id_t, warthog::sn_id_t>(
+					map.to_padded_id(startid), map.to_padded_id(goalid)));
+	}
+
+	std::vector<warthog::batch_result> results;
+	batch.run(queries, results, false);
+
+	uint32_t aborted = 0;
+	std::cout << "id\talg\texpd\tgend\ttouched\ttime\tcost\tsfile\n";
+	for(unsigned int i=0; i < results.size(); i++)
+	{
+		warthog::batch_result& res = results[i];
+		std::cout << i<<"\t" << alg_name << "\t" 
+		<< res.nodes_expanded << "\t" 
+		<< res.nodes_generated << "\t"
+		<< res.nodes_touched << "\t"
+		<< res.search_time  << "\t"
+		<< res.length << "\t" 
+		<< scenmgr.last_file_loaded() << std::endl;
+
+		if(res.status == warthog::SEARCH_ABORTED) { aborted++; }
+		else { check_optimality(res.length, scenmgr.get_experiment(i)); }
+	}
+	if(aborted) { std::cerr << "aborted queries: " << aborted << "\n"; }
+	std::cerr << "done. threads: " << batch.num_threads() 
+		<< " batch time: " << batch.get_batch_time() 
+		<< " total memory: "<< batch.mem() + scenmgr.mem() 
+		+ (ci ? ci->mem() : 0) << "\n";
+	delete ci;
+}
+
+void
+run_batch_astar(warthog::scenario_manager& scenmgr, uint32_t nthreads)
+{
+    warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	std::vector<warthog::gridmap_expansion_policy*> expanders;
+	for(uint32_t i = 0; i < nthreads; i++)
+	{
+		expanders.push_back(new warthog::gridmap_expansion_policy(&map));
+	}
+	run_batch(scenmgr, map, expanders, "astar");
+	for(uint32_t i = 0; i < nthreads; i++) { delete expanders[i]; }
+}
+
+void
+run_batch_jps(warthog::scenario_manager& scenmgr, uint32_t nthreads)
+{
+    warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	warthog::online_jump_point_locator jpl(&map);
+	std::vector<warthog::jps_expansion_policy*> expanders;
+	for(uint32_t i = 0; i < nthreads; i++)
+	{
+		expanders.push_back(new warthog::jps_expansion_policy(&map, &jpl));
+	}
+	run_batch(scenmgr, map, expanders, "jps");
+	for(uint32_t i = 0; i < nthreads; i++) { delete expanders[i]; }
+}
+
+void
+run_batch_jpsplus(warthog::scenario_manager& scenmgr, uint32_t nthreads)
+{
+    warthog::gridmap map(scenmgr.get_experiment(0)->map().c_str());
+	warthog::offline_jump_point_locator jpl(&map);
+	std::vector<warthog::jpsplus_expansion_policy*> expanders;
+	for(uint32_t i = 0; i < nthreads; i++)
+	{
+		expanders.push_back(new warthog::jpsplus_expansion_policy(&map, &jpl));
+	}
+	run_batch(scenmgr, map, expanders, "jps+");
+	for(uint32_t i = 0; i < nthreads; i++) { delete expanders[i]; }
 }
 
 int 
@@ -421,10 +812,21 @@ main(int argc, char** argv)
 		{"scen",  required_argument, 0, 0},
 		{"alg",  required_argument, 0, 1},
 		{"gen", required_argument, 0, 3},
+		{"threads", required_argument, 0, 4},
 		{"help", no_argument, &print_help, 1},
 		{"checkopt",  no_argument, &checkopt, 1},
 		{"verbose",  no_argument, &verbose, 1},
-		{"wgm",  no_argument, &wgm, 1}
+		{"wgm",  no_argument, &wgm, 1},
+		{"tiled",  no_argument, &tiled, 1},
+		{"components",  no_argument, &components, 1},
+		{"goalbounding",  no_argument, &goalbounding, 1},
+		{"queue", required_argument, 0, 5},
+		{"pool", required_argument, 0, 6},
+		{"budget", required_argument, 0, 7},
+		{"deadline", required_argument, 0, 8},
+		{"landmarks", required_argument, 0, 9},
+		{"selection", required_argument, 0, 10},
+		{0,  0, 0, 0}
 	};
 
 	warthog::util::cfg cfg;
@@ -439,6 +841,37 @@ main(int argc, char** argv)
 	std::string sfile = cfg.get_param_value("scen");
 	std::string alg = cfg.get_param_value("alg");
 	std::string gen = cfg.get_param_value("gen");
+	std::string threads = cfg.get_param_value("threads");
+	std::string queue = cfg.get_param_value("queue");
+	std::string pool = cfg.get_param_value("pool");
+	node_budget = atoi(cfg.get_param_value("budget").c_str());
+	time_limit = atof(cfg.get_param_value("deadline").c_str());
+	landmarks = atoi(cfg.get_param_value("landmarks").c_str());
+	std::string sel = cfg.get_param_value("selection");
+	if(sel != "" && sel != "avoid" && sel != "farthest")
+	{
+		std::cerr << "Err. Unknown landmark selection: "<<sel<<"\n";
+		exit(0);
+	}
+	if(sel == "farthest") { selection = warthog::landmark_ns::FARTHEST; }
+	if(pool != "" && pool != "blocklist" && pool != "flat")
+	{
+		std::cerr << "Err. Unknown node pool type: "<<pool<<"\n";
+		exit(0);
+	}
+	if(queue != "" && queue != "bheap" && queue != "4heap" && 
+			queue != "radix")
+	{
+		std::cerr << "Err. Unknown open list type: "<<queue<<"\n";
+		exit(0);
+	}
+#ifdef WARTHOG_COMPACT_NODES
+	if(queue == "bheap" || queue == "radix")
+	{
+		std::cerr << "Err. Compact search nodes require --queue 4heap\n";
+		exit(0);
+	}
+#endif
 
     // generate scenarios
 	if(gen != "")
@@ -457,14 +890,50 @@ main(int argc, char** argv)
 		exit(0);
 	}
 
+	if(tiled && (alg != "astar" || wgm || threads != "" || landmarks || 
+				goalbounding || components))
+	{
+		std::cerr << "Err. --tiled supports only astar on uniform-cost grids"
+			<< ", without --threads, --landmarks, --goalbounding or "
+			<< "--components\n";
+		exit(0);
+	}
+
 	warthog::scenario_manager scenmgr;
 	scenmgr.load_scenario(sfile.c_str());
 
+	// answer all queries as one batch, in parallel
+	if(threads != "")
+	{
+		uint32_t nthreads = atoi(threads.c_str());
+		if(nthreads == 0 || wgm)
+		{
+			std::cerr << "Err. --threads expects a positive number and "
+				<< "supports only uniform-cost grids.\n";
+			exit(0);
+		}
+
+		if(alg == "astar") { run_batch_astar(scenmgr, nthreads); }
+		else if(alg == "jps") { run_batch_jps(scenmgr, nthreads); }
+		else if(alg == "jps+") { run_batch_jpsplus(scenmgr, nthreads); }
+		else if(alg == "cpd") { run_cpd(scenmgr, nthreads); }
+		else
+		{
+			std::cerr << "Err. --threads supports only astar, cpd, jps and jps+\n";
+		}
+		exit(0);
+	}
+
 	if(alg == "jps+")
 	{
 		run_jpsplus(scenmgr);
 	}
 
+	if(alg == "cpd")
+	{
+		run_cpd(scenmgr, 0);
+	}
+
 	if(alg == "jps2")
 	{
 		run_jps2(scenmgr);
@@ -483,7 +952,15 @@ main(int argc, char** argv)
         }
         else
         {
-            run_jps(scenmgr);
+            if(pool == "flat")
+            {
+                run_jps_with<warthog::flat_jps_expansion_policy>(
+                        scenmgr, queue);
+            }
+            else
+            {
+                run_jps_with<warthog::jps_expansion_policy>(scenmgr, queue);
+            }
         }
     }
 
@@ -491,11 +968,63 @@ main(int argc, char** argv)
 	{
         if(wgm) 
         { 
-            run_wgm_astar(scenmgr); 
+            if(queue == "4heap") 
+            { 
+                run_wgm_astar< warthog::dary_heap<4> >(scenmgr); 
+            }
+#ifndef WARTHOG_COMPACT_NODES
+            else if(queue == "radix") { run_wgm_astar<warthog::radix_heap>(scenmgr); }
+#endif
+            else { run_wgm_astar<warthog::default_open_list>(scenmgr); }
+        }
+        else if(tiled)
+        {
+            if(pool == "flat")
+            {
+                run_tiled_astar_with<warthog::flat_blockmap_expansion_policy>(
+                        scenmgr, queue);
+            }
+            else
+            {
+                run_tiled_astar_with<warthog::blockmap_expansion_policy>(
+                        scenmgr, queue);
+            }
         }
         else 
         { 
-            run_astar(scenmgr); 
+            if(pool == "flat")
+            {
+                run_astar_with<warthog::flat_gridmap_expansion_policy>(
+                        scenmgr, queue);
+            }
+            else
+            {
+                run_astar_with<warthog::gridmap_expansion_policy>(
+                        scenmgr, queue);
+            }
+        }
+	}
+
+	if(alg == "bi-astar")
+	{
+        if(wgm) 
+        { 
+            // NB: heuristic scaled as per run_wgm_astar
+            run_bi_astar_with<warthog::weighted_gridmap, 
+                warthog::wgridmap_expansion_policy>(
+                        scenmgr, queue, "bi-astar_wgm", '.');
+        }
+        else if(pool == "flat")
+        {
+            run_bi_astar_with<warthog::gridmap, 
+                warthog::flat_gridmap_expansion_policy>(
+                        scenmgr, queue, "bi-astar", 1.0);
+        }
+        else
+        {
+            run_bi_astar_with<warthog::gridmap, 
+                warthog::gridmap_expansion_policy>(
+                        scenmgr, queue, "bi-astar", 1.0);
         }
 	}
 